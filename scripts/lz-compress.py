@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+"""
+@file lz-compress.py
+@author Daniel Starke
+@copyright Copyright 2023 Daniel Starke
+@date 2026-10-14
+@version 2026-10-14
+
+Compresses a file for lzCopyVram()/lzCopyWram() (see src/utility.asm).
+Usage: lz-compress.py <input> <output>
+
+Format:
+2 bytes uncompressed size (little endian), followed by tokens:
+0LLLLLLL          - copy the next L+1 bytes (1..128)
+1LLLLLLL DDDDDDDD DDDDDDDD
+                  - copy L+3 bytes (3..130) from D bytes back (1..2048, little endian);
+                    the source may overlap with the destination (runs)
+"""
+
+import sys
+
+WINDOW = 2048     # needs to match with LZ_WINDOW in utility.asm
+MIN_MATCH = 3
+MAX_MATCH = 130
+MAX_LITERAL = 128
+
+inData = open(sys.argv[1], 'rb').read()
+if len(inData) > 0xFFFF:
+    sys.exit('Error: ' + sys.argv[1] + ' exceeds 65535 bytes')
+
+outData = bytearray([len(inData) & 0xFF, len(inData) >> 8])
+literals = bytearray()
+chains = {}
+
+def flushLiterals():
+    global literals
+    while len(literals) > 0:
+        part = literals[:MAX_LITERAL]
+        outData.append(len(part) - 1)
+        outData.extend(part)
+        literals = literals[MAX_LITERAL:]
+
+def addPosition(pos):
+    if pos + MIN_MATCH <= len(inData):
+        chains.setdefault(inData[pos:pos + MIN_MATCH], []).append(pos)
+
+pos = 0
+while pos < len(inData):
+    # find the longest match within the window (greedy)
+    bestLen = 0
+    bestDist = 0
+    for start in reversed(chains.get(inData[pos:pos + MIN_MATCH], [])):
+        dist = pos - start
+        if dist > WINDOW:
+            break
+        length = 0
+        while length < MAX_MATCH and pos + length < len(inData) and inData[start + length] == inData[pos + length]:
+            length += 1
+        if length > bestLen:
+            bestLen = length
+            bestDist = dist
+            if length == MAX_MATCH:
+                break
+    if bestLen >= MIN_MATCH:
+        flushLiterals()
+        outData.extend([0x80 | (bestLen - MIN_MATCH), bestDist & 0xFF, bestDist >> 8])
+        for i in range(bestLen):
+            addPosition(pos + i)
+        pos += bestLen
+    else:
+        literals.append(inData[pos])
+        addPosition(pos)
+        pos += 1
+flushLiterals()
+
+open(sys.argv[2], 'wb').write(outData)
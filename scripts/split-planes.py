@@ -0,0 +1,21 @@
+#!/usr/bin/env python
+"""
+@file split-planes.py
+@author Daniel Starke
+@copyright Copyright 2023 Daniel Starke
+@date 2026-10-14
+@version 2026-10-14
+
+Splits a tile map of 16-bit little endian words into its low byte plane
+(tile indices) and high byte plane (attributes).
+Usage: split-planes.py <input map> <output low> <output high>
+"""
+
+import sys
+
+inData = open(sys.argv[1], 'rb').read()
+if (len(inData) % 2) != 0:
+    sys.exit('Error: Odd number of bytes in ' + sys.argv[1])
+
+open(sys.argv[2], 'wb').write(inData[0::2])
+open(sys.argv[3], 'wb').write(inData[1::2])
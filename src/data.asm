@@ -2,53 +2,59 @@
 ; @author Daniel Starke
 ; @copyright Copyright 2023 Daniel Starke
 ; @date 2023-07-03
-; @version 2023-07-13
+; @version 2026-10-14
+
+.equ MAP_SIZE 2048 ; needs to match with MAP_PAGE_SIZE in main.c
+
+.RAMSECTION ".reg_maps7f" BANK $7F
+; tile maps decompressed at start-up for the VRAM transfer queue (see lzCopyWram())
+bg1Map:           DSB MAP_SIZE
+bg2Map:           DSB MAP_SIZE
+fg1Map:           DSB MAP_SIZE
+optionsMap:       DSB MAP_SIZE
+.ends
 
 .include "hdr.asm"
 
 
 .section ".rodata1" superfree
 
-bg1Tiles:
-.incbin "bg1.chr"
-bg1TilesEnd:
+bg1TilesLz:
+.incbin "bg1.chr.lz"
 
-fg1Tiles:
-.incbin "fg1.chr"
-fg1TilesEnd:
+fg1TilesLz:
+.incbin "fg1.chr.lz"
 
-fg2Tiles:
-.incbin "fg2.chr"
-fg2TilesEnd
+fg2TilesLz:
+.incbin "fg2.chr.lz"
 
-p12Tiles:
-.incbin "p12.chr"
-p12TilesEnd
+p12TilesLz:
+.incbin "p12.chr.lz"
 
 .ends
 
 
 .section ".rodata2" superfree
 
-bg1Map:
-.incbin "bg1.map"
-bg1MapEnd:
+bg1MapLz:
+.incbin "bg1.map.lz"
 
-bg2Map:
-.incbin "bg2.map"
-bg2MapEnd:
+bg2MapLz:
+.incbin "bg2.map.lz"
 
-fg1Map:
-.incbin "fg1.map"
-fg1MapEnd:
+fg1MapLz:
+.incbin "fg1.map.lz"
 
-optionsMap:
-.incbin "options.map"
-optionsMapEnd:
+optionsMapLz:
+.incbin "options.map.lz"
 
-fieldMap:
-.incbin "field.map"
-fieldMapEnd:
+fieldMapLow:
+.incbin "field.low"
+fieldMapLowEnd:
+
+fieldMapHigh:
+.incbin "field.high"
+fieldMapHighEnd:
 
 bg1Pal:
 .incbin "bg1.pal"
@@ -77,4 +83,15 @@ sfx1:
 sfx1End:
 
 .ends
-.endif
\ No newline at end of file
+.endif
+
+
+.ifdef USE_REPLAY
+.section ".rodata4" superfree
+
+replayData:
+.incbin "replay.bin"
+replayDataEnd:
+
+.ends
+.endif
@@ -2,13 +2,52 @@
 ; @author Daniel Starke
 ; @copyright Copyright 2023 Daniel Starke
 ; @date 2023-07-16
-; @version 2023-07-21
+; @version 2026-10-14
 
 .RAMSECTION ".reg_debug7e" BANK $7E
 ; extern const char * debugMessage;
 debugMessage:     DSW 2 ; debug message
+; extern tFrameStats frameStats;
+frameStats:       DSW 3 ; game frames, lag frames and dropped frames (see debug.h)
 .ends
 
+.ifndef NDEBUG
+.equ REG_CGWSEL     $2130
+.equ REG_CGADSUB    $2131
+.equ REG_COLDATA    $2132
+.equ REG_SLHV       $2137
+.equ REG_OPVCT      $213D
+.equ REG_STAT78     $213F
+
+.equ PROFILE_SECTIONS 8 ; needs to match with debug.h
+.ifdef USE_NTSC
+.equ PROFILE_LINES  262 ; scanlines per frame
+.else
+.equ PROFILE_LINES  312 ; scanlines per frame
+.endif
+
+.RAMSECTION ".reg_profile7e" BANK $7E
+profileStart:     DSW PROFILE_SECTIONS ; vertical counter at section entry
+; extern uint16_t profileLast[PROFILE_SECTIONS];
+profileLast:      DSW PROFILE_SECTIONS ; scanlines used by the last pass of each section
+; extern uint16_t profilePeak[PROFILE_SECTIONS];
+profilePeak:      DSW PROFILE_SECTIONS ; maximum scanlines used by each section
+profileStack:     DSB PROFILE_SECTIONS ; entered sections (for the raster bar color)
+profileDepth:     DSW 1 ; number of valid items in profileStack
+.ends
+.endif ; not NDEBUG
+
+.ifdef BENCH
+.equ BENCH_SCENARIOS 5 ; needs to match with debug.h
+
+.RAMSECTION ".reg_bench7e" BANK $7E
+; extern tBenchResult benchResult[BENCH_SCENARIOS];
+benchResult:      DSW (BENCH_SCENARIOS * 4) ; minimal, average and maximal frame cost and lag frames per scenario
+; extern uint8_t benchDone;
+benchDone:        DSB 1 ; all scenarios completed
+.ends
+.endif ; BENCH
+
 .include "hdr.asm"
 .accu 16
 .index 16
@@ -24,3 +63,193 @@ debugBreak:
 	rtl                ; return from subroutine long
 
 .ends
+
+
+.ifndef NDEBUG
+.section ".profile_text" superfree
+; void profileInit(void);
+profileInit:
+	php                ; push processor flags to stack (1 byte)
+	rep #$30           ; 16-bit accumulator and index registers
+	stz.w profileDepth
+	; no pending spans (see profileSpanEnd)
+	lda #$FFFF
+	ldx #((PROFILE_SECTIONS - 1) * 2)
+_profileInitLoop:
+	sta.w profileStart,x
+	dex
+	dex
+	bpl _profileInitLoop
+	sep #$20           ; 8-bit accumulator
+	lda #$00
+	sta.l REG_CGWSEL   ; always add the fixed color
+	lda #$3F
+	sta.l REG_CGADSUB  ; add to all layers and the backdrop
+	lda #$E0
+	sta.l REG_COLDATA  ; fixed color black (no raster bar)
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; void profileBegin(const uint16_t id);
+profileBegin:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 5 | 2 byte id
+	                   ; 1 | 4 byte return address
+	                   ; 0 | 1 byte processor flags
+
+	rep #$30           ; 16-bit accumulator and index registers
+	lda 5,s
+	and #(PROFILE_SECTIONS - 1)
+	tay                ; y = section
+	asl A              ; two bytes per section entry
+	tax                ; copy accumulator to x register
+	jsr _profileCounter
+	sta.w profileStart,x
+	; remember section for the raster bar of nested sections
+	ldx.w profileDepth
+	cpx #PROFILE_SECTIONS
+	bcs _profileBeginColor ; too deeply nested
+	tya                ; copy y register to accumulator
+	sep #$20           ; 8-bit accumulator
+	sta.w profileStack,x
+	rep #$20           ; 16-bit accumulator
+	inx
+	stx.w profileDepth
+_profileBeginColor:
+	jsr _profileColor
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; void profileEnd(const uint16_t id);
+profileEnd:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 5 | 2 byte id
+	                   ; 1 | 4 byte return address
+	                   ; 0 | 1 byte processor flags
+
+	rep #$30           ; 16-bit accumulator and index registers
+	lda 5,s
+	and #(PROFILE_SECTIONS - 1)
+	asl A              ; two bytes per section entry
+	tax                ; copy accumulator to x register
+	jsr _profileCounter
+	jsr _profileUpdate
+	; restore the raster bar of the enclosing section
+	ldx.w profileDepth
+	beq _profileEndOff
+	dex
+	stx.w profileDepth
+	beq _profileEndOff
+	lda.w profileStack-1,x
+	and #$00FF
+	tay                ; y = enclosing section
+	jsr _profileColor
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+_profileEndOff:
+	jsr _profileColorOff
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; void profileSpanBegin(const uint16_t id);
+profileSpanBegin:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 5 | 2 byte id
+	                   ; 1 | 4 byte return address
+	                   ; 0 | 1 byte processor flags
+
+	rep #$30           ; 16-bit accumulator and index registers
+	lda 5,s
+	and #(PROFILE_SECTIONS - 1)
+	asl A              ; two bytes per section entry
+	tax                ; copy accumulator to x register
+	jsr _profileCounter
+	sta.w profileStart,x
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; void profileSpanEnd(const uint16_t id);
+profileSpanEnd:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 5 | 2 byte id
+	                   ; 1 | 4 byte return address
+	                   ; 0 | 1 byte processor flags
+
+	rep #$30           ; 16-bit accumulator and index registers
+	lda 5,s
+	and #(PROFILE_SECTIONS - 1)
+	asl A              ; two bytes per section entry
+	tax                ; copy accumulator to x register
+	lda.w profileStart,x
+	bmi _profileSpanEndDone ; no span pending
+	jsr _profileCounter
+	jsr _profileUpdate
+	lda #$FFFF
+	sta.w profileStart,x ; span completed
+_profileSpanEndDone:
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; Updates profileLast and profilePeak of the section in x with the vertical
+; counter in a. Keeps x. Requires 16-bit registers.
+_profileUpdate:
+	sec
+	sbc.w profileStart,x
+	bcs _profileUpdateLast
+	adc #PROFILE_LINES ; section passed the end of the frame
+_profileUpdateLast:
+	sta.w profileLast,x
+	cmp.w profilePeak,x
+	bcc _profileUpdateEnd
+	sta.w profilePeak,x
+_profileUpdateEnd:
+	rts                ; return from subroutine
+
+; Returns the current vertical counter in a. Keeps x and y. Requires 16-bit registers.
+_profileCounter:
+	sep #$20           ; 8-bit accumulator
+	lda.l REG_STAT78   ; reset the REG_OPVCT low/high byte selection
+	lda.l REG_SLHV     ; latch the H/V counters
+	lda.l REG_OPVCT    ; low byte
+	xba                ; exchange low and high byte of the accumulator
+	lda.l REG_OPVCT    ; high byte (only bit 0 is valid)
+	and #$01
+	xba                ; exchange low and high byte of the accumulator
+	rep #$20           ; 16-bit accumulator
+	rts                ; return from subroutine
+
+; Sets the raster bar color of the section in y. Requires 16-bit registers.
+_profileColor:
+	tyx                ; copy y register to x register
+	sep #$20           ; 8-bit accumulator
+	lda #$E0
+	sta.l REG_COLDATA  ; clear all color channels
+	lda.l _profileColors,x
+	sta.l REG_COLDATA  ; set the section color channels
+	rep #$20           ; 16-bit accumulator
+	rts                ; return from subroutine
+
+; Removes the raster bar. Requires 16-bit registers.
+_profileColorOff:
+	sep #$20           ; 8-bit accumulator
+	lda #$E0
+	sta.l REG_COLDATA  ; clear all color channels
+	rep #$20           ; 16-bit accumulator
+	rts                ; return from subroutine
+
+_profileColors:
+	.db $28 ; red
+	.db $48 ; green
+	.db $88 ; blue
+	.db $68 ; yellow
+	.db $C8 ; cyan
+	.db $A8 ; magenta
+	.db $E8 ; white
+	.db $E4 ; gray
+
+.ends
+.endif ; not NDEBUG
@@ -3,16 +3,60 @@
 * @author Daniel Starke
 * @copyright Copyright 2023 Daniel Starke
 * @date 2023-07-16
-* @version 2023-07-21
+* @version 2026-10-14
 */
 #ifndef _DEBUG_H_
 #define _DEBUG_H_
 
 #include <stddef.h>
+#include <stdint.h>
+
+
+/** Number of profiler sections (see `PROFILE_BEGIN`). Needs to match with debug.asm. */
+#define PROFILE_SECTIONS 8
+
+
+/** Frame statistics of the game screen (see `handleGame()`). */
+typedef struct {
+	uint16_t gameFrames; /**< number of elapsed frames on the game screen */
+	uint16_t lagFrames; /**< number of frames without a `handleGame()` call (missed the frame budget) */
+	uint16_t droppedFrames; /**< number of lag frames exceeding the catch-up of the game clock */
+} tFrameStats;
 
 
 /** Found in `debug.asm`. */
 extern const char * debugMessage;
+/** Found in `debug.asm`. Frame statistics for inspection via the symbol file. */
+extern tFrameStats frameStats;
+
+
+#ifndef NDEBUG
+/** Found in `debug.asm`. Scanlines used by the last pass of each profiler section. */
+extern uint16_t profileLast[PROFILE_SECTIONS];
+/** Found in `debug.asm`. Maximum scanlines used by each profiler section. */
+extern uint16_t profilePeak[PROFILE_SECTIONS];
+#endif /* not NDEBUG */
+
+
+#ifdef BENCH
+/** Number of benchmark scenarios (see `runBenchmark()`). Needs to match with debug.asm. */
+#define BENCH_SCENARIOS 5
+
+
+/** Result of a single benchmark scenario. All frame costs are given in scanlines. */
+typedef struct {
+	uint16_t minCost; /**< minimal frame cost */
+	uint16_t avgCost; /**< average frame cost */
+	uint16_t maxCost; /**< maximal frame cost */
+	uint16_t lagFrames; /**< number of missed frames */
+} tBenchResult;
+
+
+/** Found in `debug.asm`. Results of all benchmark scenarios. */
+extern tBenchResult benchResult[BENCH_SCENARIOS];
+/** Found in `debug.asm`. Set to 1 once all benchmark scenarios have completed. */
+extern uint8_t benchDone;
+#endif /* BENCH */
 
 
 /** Concatenates two tokens. */
@@ -60,10 +104,105 @@ extern const char * debugMessage;
 #endif /* NDEBUG */
 
 
+/**
+ * @def PROFILE_INIT()
+ * Enables the profiler raster bars. Each entered profiler section adds its
+ * color to the screen lines until it is left again.
+ *
+ * @remarks Uses the color math registers (fixed color addition).
+ */
+/**
+ * @def PROFILE_BEGIN(id)
+ * Latches the vertical counter at the entry of the given profiler section.
+ *
+ * @param id - profiler section (0 to `PROFILE_SECTIONS - 1`)
+ */
+/**
+ * @def PROFILE_END(id)
+ * Latches the vertical counter at the exit of the given profiler section and
+ * updates `profileLast` and `profilePeak` with the used scanlines.
+ *
+ * @param id - profiler section (0 to `PROFILE_SECTIONS - 1`)
+ * @remarks Sections are measured modulo one frame.
+ */
+/**
+ * @def PROFILE_SPAN_BEGIN(id)
+ * Latches the vertical counter at the start of the given profiler span.
+ * Spans are not shown as raster bar and may end in a different context
+ * (e.g. the VBlank handler).
+ *
+ * @param id - profiler section (0 to `PROFILE_SECTIONS - 1`)
+ */
+/**
+ * @def PROFILE_SPAN_END(id)
+ * Updates `profileLast` and `profilePeak` with the scanlines since the last
+ * `PROFILE_SPAN_BEGIN()` of the given profiler span. Does nothing if the span
+ * has not been started again since its last end.
+ *
+ * @param id - profiler section (0 to `PROFILE_SECTIONS - 1`)
+ * @remarks Spans are measured modulo one frame.
+ */
+#ifndef NDEBUG
+#define PROFILE_INIT() profileInit()
+#define PROFILE_BEGIN(id) profileBegin(id)
+#define PROFILE_END(id) profileEnd(id)
+#define PROFILE_SPAN_BEGIN(id) profileSpanBegin(id)
+#define PROFILE_SPAN_END(id) profileSpanEnd(id)
+#else /* NDEBUG */
+#define PROFILE_INIT()
+#define PROFILE_BEGIN(id)
+#define PROFILE_END(id)
+#define PROFILE_SPAN_BEGIN(id)
+#define PROFILE_SPAN_END(id)
+#endif /* NDEBUG */
+
+
 /**
  * Calls the break command.
  */
 void debugBreak();
 
 
+#ifndef NDEBUG
+/**
+ * Initializes the profiler. Use `PROFILE_INIT()` instead.
+ */
+void profileInit(void);
+
+
+/**
+ * Marks the entry of a profiler section. Use `PROFILE_BEGIN()` instead.
+ *
+ * @param[in] id - profiler section
+ */
+void profileBegin(const uint16_t id);
+
+
+/**
+ * Marks the exit of a profiler section. Use `PROFILE_END()` instead.
+ *
+ * @param[in] id - profiler section
+ * @remarks A profiler section interrupted by the NMI handler may rarely get a
+ * wrong value if the NMI handler uses the profiler itself.
+ */
+void profileEnd(const uint16_t id);
+
+
+/**
+ * Marks the start of a profiler span. Use `PROFILE_SPAN_BEGIN()` instead.
+ *
+ * @param[in] id - profiler section
+ */
+void profileSpanBegin(const uint16_t id);
+
+
+/**
+ * Marks the end of a profiler span. Use `PROFILE_SPAN_END()` instead.
+ *
+ * @param[in] id - profiler section
+ */
+void profileSpanEnd(const uint16_t id);
+#endif /* not NDEBUG */
+
+
 #endif /* _DEBUG_H_ */
@@ -2,7 +2,7 @@
 ; @author Daniel Starke
 ; @copyright Copyright 2023 Daniel Starke
 ; @date 2023-07-03
-; @version 2023-07-16
+; @version 2026-10-14
 
 
 ;==LoRom==
@@ -25,7 +25,11 @@
   NAME "Bomb'n'Break         "  ; Program Title - can't be over 21 bytes,
   ;    "123456789012345678901"  ; use spaces for unused bytes of the name.
 
+.IFDEF USE_FASTROM
+  FASTROM                       ; 3.58 MHz ROM access via the banks $80 and above (see fastRomInit())
+.ELSE
   SLOWROM
+.ENDIF
   LOROM
 
   CARTRIDGETYPE $00             ; $00=ROM, $01=ROM+RAM, $02=ROM+SRAM, $03=ROM+DSP1, $04=ROM+RAM+DSP1, $05=ROM+SRAM+DSP1, $13=ROM+Super FX
@@ -55,3 +59,9 @@
   RESET tcc__start              ; where execution starts
   IRQBRK EmptyHandler
 .ENDEMUVECTOR
+
+.IFDEF USE_FASTROM
+; Labels of the following ROM sections of the including file refer to the fast
+; bank mirror ($80 and above). The vectors above are 16-bit and remain valid.
+.BASE $80
+.ENDIF
@@ -3,7 +3,7 @@
  * @author Daniel Starke
  * @copyright Copyright 2023 Daniel Starke
  * @date 2023-07-03
- * @version 2023-07-29
+ * @version 2026-10-14
  *
  * Bomb'n'Break for SNES.
  */
@@ -15,6 +15,9 @@
 #ifdef HAS_BGM
 #include "bgm1.h"
 #endif /* HAS_BGM */
+#ifdef HAS_SFX
+#include "sfx.h"
+#endif /* HAS_SFX */
 
 
 /**
@@ -35,6 +38,19 @@
 #define DEF_MAX_BOMBS 5
 /** Default value for `maxRange` (at most `MAX_RANGE`). */
 #define DEF_MAX_RANGE 9
+#if defined(USE_REPLAY) && defined(REC_REPLAY)
+#error "USE_REPLAY and REC_REPLAY cannot be used together."
+#endif /* USE_REPLAY and REC_REPLAY */
+#if defined(USE_REPLAY) || defined(REC_REPLAY)
+/** Fixed random seed for reproducible matches in replay builds. */
+#define REPLAY_SEED 0x5EED0040
+#endif /* USE_REPLAY or REC_REPLAY */
+#ifdef REC_REPLAY
+/** Number of entries in `replayBuffer` (including the end marker). */
+#define REPLAY_RECORD_SIZE 512
+#endif /* REC_REPLAY */
+/** Maximum number of players (four with a multitap in the second controller port). */
+#define MAX_PLAYERS 4
 /** Maximum value for `maxBombs`. */
 #define MAX_BOMBS 9
 /** Maximum value for `maxRange`. */
@@ -45,14 +61,42 @@
 #define BOMB_TTL 35
 /** Time to live of the boots power-up in 1/10s units. */
 #define BOOTS_TTL 150
-/** May be set in `tPlayer.lastBombIdx` if the field is invalid. */
-#define INVALID_LAST_BOMB_IDX 255
+/** Marks an invalid `bombPool` index (e.g. in `tPlayer.lastBombIdx`). Needs to match with utility.asm. */
+#define INVALID_BOMB 255
+/** Number of entries in `bombPool`. */
+#define MAX_BOMB_POOL (MAX_BOMBS * MAX_PLAYERS)
+/** Number of slots in `bombWheel` (power of two greater than `BOMB_ANIMATION`). */
+#define BOMB_WHEEL_SIZE 4
 /** Time per bomb animation frame in 1/10s units. */
 #define BOMB_ANIMATION 2
 /** Time per player animation frame in 1/10s units. */
 #define PLAYER_ANIMATION 1
-/** Time per player animation frame in 1/10s units. */
+/** Time per explosion animation frame in 1/10s units. Needs to match with utility.asm. */
 #define EXPLOSION_ANIMATION 1
+/** Marks an invalid `cellMap` index (e.g. in `tCpu.bombCell`). */
+#define INVALID_CELL 255
+
+
+/** Maximum number of `dangerQueue` bombs painted into `dangerTick` per frame (see `updateDanger()`). */
+#define DANGER_BUDGET 2
+/** Number of cells expanded per frame by the path search of the CPU players (see `searchStep()`). */
+#define CPU_SEARCH_BUDGET 8
+/** Number of cells expanded per idle task slice by the path search of the CPU players (see `idleSearch()`). */
+#define CPU_IDLE_BUDGET 2
+/** Maximum path length in cells of a single CPU player decision (limits the path search depth). */
+#define CPU_PATH_LEN 8
+/** Maximum path length in cells from a dropped bomb to a cell out of its reach for a CPU player. */
+#define CPU_ESCAPE_DIST 4
+/** Time in 1/10s units a player needs to cross a game field cell (16 pixels at one pixel per frame) with margin. */
+#define CPU_CELL_TICKS 4
+
+
+/**
+ * Maximum number of lag frames the game clock lags behind. These are caught
+ * up by the following `handleGame()` calls with at most one tick phase per
+ * call (see `TICK_ANIMATION`). Further lag frames are dropped (see `frameStats`).
+ */
+#define MAX_CATCH_UP_FRAMES 2
 
 
 /** Default BGM volume (0..255). */
@@ -69,10 +113,22 @@
 #define INVALID_NR 7
 
 
-/** SNES sprite ID for the player 1 sprite (in steps of 4). */
-#define P1_NR 0
-/** SNES sprite ID for the player 2 sprite (in steps of 4). */
-#define P2_NR 4
+/** Number of status rows above the game field (see `hudField`). */
+#define HUD_ROWS 2
+/** Number of tiles per status row (see `hudField`). */
+#define HUD_COLS 32
+
+
+/** Sprite y coordinate below the visible screen lines to hide a sprite. */
+#define SPRITE_HIDE_Y 240
+/**
+ * Returns the sprite attribute byte for the given parameters.
+ *
+ * @param palette - sprite palette (0 to 7)
+ * @param priority - sprite priority (0 to 3)
+ * @param flipX - flip sprite horizontal? 0 or 1
+ */
+#define SPRITE_ATTR(palette, priority, flipX) ((uint8_t)(((flipX) << 6) | ((priority) << 4) | ((palette) << 1)))
 
 
 /* player sprite boundary box (relative to the upper left corner) */
@@ -90,13 +146,13 @@
 #define P_MID_Y  12
 
 
-/** VRAM byte offset for `bg1Tiles`. */
+/** VRAM byte offset for `bg1TilesLz`. */
 #define CHR_VRAM_BG1 0x6000
-/** VRAM byte offset for `fg1Tiles`. */
+/** VRAM byte offset for `fg1TilesLz`. */
 #define CHR_VRAM_FG1 0x8000
-/** VRAM byte offset for `fg2Tiles`. */
+/** VRAM byte offset for `fg2TilesLz`. */
 #define CHR_VRAM_FG2 0xA000
-/** VRAM byte offset for `p12Tiles`. */
+/** VRAM byte offset for `p12TilesLz`. */
 #define CHR_VRAM_P1  0x0000
 /** VRAM byte offset for background map page 1. */
 #define MAP_VRAM_BG  0x2000
@@ -104,10 +160,17 @@
 #define MAP_VRAM_FG  0x4000
 
 
-/** Size in bytes of a single 32x32 tile map. */
+/** Size in bytes of a single 32x32 tile map. Needs to match with `MAP_SIZE` in data.asm. */
 #define MAP_PAGE_SIZE (32*32*2)
 
 
+/**
+ * Maximum number of changed 16x16 game field elements being rendered and
+ * transferred to VRAM per frame. Further changes are deferred to the next frame.
+ */
+#define MAX_RENDER_CELLS 16
+
+
 /**
  * Converts the byte offset to a word offset.
  *
@@ -139,6 +202,67 @@
 #define TILE_OFFSET_1(x, y) (((uint16_t)(y) * 32) + (x) + 1)
 
 
+/**
+ * Returns the `cellMap` index of the 16x16 game field element with
+ * the given upper left tile coordinate (see `TILE_OFFSET_1`).
+ *
+ * @param[in] x - x coordinate (even)
+ * @param[in] y - y coordinate (even)
+ * @return `cellMap` index
+ */
+#define FIELD_CELL(x, y) ((uint8_t)(((uint8_t)(y) << 3) | ((uint8_t)(x) >> 1)))
+
+
+/**
+ * Returns the `cellMap` index of the 16x16 game field element at
+ * the given sprite pixel coordinate.
+ *
+ * @param[in] x - x pixel coordinate
+ * @param[in] y - y pixel coordinate
+ * @return `cellMap` index
+ */
+#define PIXEL_CELL(x, y) ((uint8_t)(((uint8_t)(y) & 0xF0) | ((uint8_t)(x) >> 4)))
+
+
+/**
+ * Returns the upper left tile map offset of the 16x16 game field
+ * element with the given `cellMap` index.
+ *
+ * @param[in] cell - `cellMap` index
+ * @return upper left tile offset (word offset; see `TILE_OFFSET_1`)
+ */
+#define CELL_INDEX(cell) ((uint16_t)((((uint16_t)(cell) & 0xF0) << 2) | (((cell) & 0x0F) << 1)) + 1)
+
+
+/**
+ * Returns the `cellGfx` value for the given graphic variant.
+ *
+ * @param[in] flip - `GFX_FLIP_X`, `GFX_FLIP_Y` or 0
+ * @param[in] shape - explosion shape (e.g. `SHAPE_MID`; flames only)
+ * @param[in] frame - animation frame (0..7)
+ * @return `cellGfx` value
+ */
+#define CELL_GFX(flip, shape, frame) ((uint8_t)((flip) | ((shape) << 3) | (frame)))
+
+
+/**
+ * Returns the explosion shape of the given `cellGfx` value.
+ *
+ * @param[in] gfx - `cellGfx` value
+ * @return explosion shape (e.g. `SHAPE_MID`)
+ */
+#define GFX_SHAPE(gfx) (((gfx) >> 3) & 0x07)
+
+
+/**
+ * Returns the animation frame of the given `cellGfx` value.
+ *
+ * @param[in] gfx - `cellGfx` value
+ * @return animation frame (0..7)
+ */
+#define GFX_FRAME(gfx) ((gfx) & 0x07)
+
+
 /**
  * Returns the constructed tile attribute byte (high byte of a tile map entry).
  *
@@ -161,6 +285,42 @@
 /** Vertical screen offset in pixels. Use -1 to render the first line correctly. */
 #define VERT_OFFSET -1
 
+/** Number of screen lines showing the status rows which are not scrolled by the camera (see `cameraY`). */
+#define HUD_LINES ((HUD_ROWS * 8) - VERT_OFFSET)
+
+/** Maximum camera offset in pixels (game field rows beyond the 14 rows of the screen). */
+#define CAMERA_MAX ((CELL_ROWS - 14) * 16)
+
+/** Smallest player y coordinate relative to the camera with the sprite below the status rows. */
+#define CAMERA_TOP (HUD_ROWS * 8)
+
+/** Largest player y coordinate relative to the camera with the sprite within the screen. */
+#define CAMERA_BOTTOM (223 + VERT_OFFSET - 15)
+
+/** Player y coordinate which the camera keeps in the middle of the scrolled screen lines. */
+#define CAMERA_MID ((((HUD_ROWS * 8) + 224) / 2) - 8)
+
+/**
+ * Returns the lowest game field row which needs to be present in VRAM for the
+ * given camera offset. This is one row below the last visible row.
+ *
+ * @param[in] offset - camera offset in pixels (see `cameraY`)
+ * @return game field row
+ */
+#define CAMERA_ROW_AHEAD(offset) ((uint8_t)(((uint16_t)(offset) + 223 + VERT_OFFSET + 16) >> 4))
+
+/**
+ * @def MAP_FIELD_ROWS
+ * Number of game field rows taken from `fieldMapLow`. The rows below are
+ * streamed by `renderCells()`. The last row of `fieldMapLow` is the bottom
+ * wall which becomes a regular row in the large arena.
+ */
+#ifdef USE_LARGE_ARENA
+#define MAP_FIELD_ROWS 13
+#else /* not USE_LARGE_ARENA */
+#define MAP_FIELD_ROWS CELL_ROWS
+#endif /* not USE_LARGE_ARENA */
+
 /**
  *  @def SLIDE_SPEED
  *  Slide in/out speed in pixels per vertical blank.
@@ -183,21 +343,79 @@
 #endif /* USE_PAL */
 
 
+/**
+ *  @def FRAME_LINES
+ *  Scanlines per frame.
+ */
+#ifdef USE_NTSC
+#define FRAME_LINES 262
+#else /* USE_PAL */
+#define FRAME_LINES 312
+#endif /* USE_PAL */
+/** First scanline of the vertical blank (start of the NMI handler). */
+#define VBLANK_LINE 225
+/** Last scanline at which `latchPads()` starts `padsLatch()` (takes about 3 scanlines). */
+#define LATCH_END_LINE (VBLANK_LINE - 8)
+
+
+#ifdef BENCH
+/** Measured frames per benchmark scenario as power of two (see `BENCH_FRAMES`). */
+#define BENCH_FRAMES_LOG2 8
+/** Measured frames per benchmark scenario. */
+#define BENCH_FRAMES (1 << BENCH_FRAMES_LOG2)
+/** Time until the first scheduled bomb explodes in a benchmark scenario in 1/10s units. */
+#define BENCH_FUSE 2
+#endif /* BENCH */
+
+
+/**
+ * Scanline up to which `runIdleTasks()` performs deferrable work. Keeps
+ * the last task slice ahead of the VBlank period.
+ */
+#define IDLE_END_LINE 220
+/** Scanlines added to the cost of a slice which overran into the VBlank period (see `idlePeak`). */
+#define IDLE_OVERRUN_LINES 8
+/** Estimated scanlines of a single `idleSearch()` slice until measured (see `idlePeak`). */
+#define IDLE_SEARCH_LINES 24
+
+
 #if defined(HAS_BGM) || defined(HAS_SFX)
 /**
- * Overwrite `WaitForVBlank()` to ensure that
- * spcProcess() is being called for every frame.
+ * Overwrite `WaitForVBlank()` to ensure that the `hudField`
+ * changes and VRAM updates queued so far are being committed,
+ * spcProcess() is being called for every frame once the audio boot
+ * completed and
+ * the remaining frame time runs the idle tasks.
  */
 #define WaitForVBlank() \
-	spcProcess(); \
+	flushHud(); \
+	frameReady = true; \
+	if ( audioStage == AUDIO_READY ) { \
+		spcProcess(); \
+	} \
+	runIdleTasks(); \
 	WaitForVBlank()
-#endif /* HAS_BGM or HAS_SFX */
+#else /* not HAS_BGM and not HAS_SFX */
+/**
+ * Overwrite `WaitForVBlank()` to ensure that the `hudField`
+ * changes and VRAM updates queued so far are being committed and
+ * the remaining frame time runs the idle tasks.
+ */
+#define WaitForVBlank() \
+	flushHud(); \
+	frameReady = true; \
+	runIdleTasks(); \
+	WaitForVBlank()
+#endif /* not HAS_BGM and not HAS_SFX */
 
 
 /**
  * Delay execution a bit after each key pressed.
  */
-#define clickDelay() WaitNVBlank(FP10HZ)
+#define clickDelay() \
+	flushHud(); \
+	frameReady = true; \
+	WaitNVBlank(FP10HZ)
 
 
 /**
@@ -214,109 +432,104 @@
 
 
 /**
- * Clears the tiles of a 16x16 game field element.
+ * @def latchPads()
+ * Samples `pads` of the two controller ports again right before the player
+ * handling. This reduces the input latency by the time of the preceding game
+ * logic. Deterministic builds and multitap setups keep the values of
+ * `readPads()`. The same applies if the frame is too close to the VBlank
+ * period or if the VBlank handler interrupted the serial read, since the
+ * auto-joypad read of the hardware clocks the same ports.
  *
- * @param field - upper left game field tile pointer
+ * @remarks Uses `latchVBlank` internally.
  */
-#define clearField(field) \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x00); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x01); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x20); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x21); \
-	(field)[0x00] = FIELD_EMPTY; \
-	(field)[0x01] = FIELD_EMPTY; \
-	(field)[0x20] = FIELD_EMPTY; \
-	(field)[0x21] = FIELD_EMPTY; \
-	refreshGameScreenLow = true;
+#if defined(USE_REPLAY) || defined(REC_REPLAY) || defined(BENCH)
+#define latchPads()
+#else /* not USE_REPLAY and not REC_REPLAY and not BENCH */
+#define latchPads() \
+	if ( ! snes_mplay5 && getScanline() < LATCH_END_LINE ) { \
+		latchVBlank = snes_vblank_count; \
+		padsLatch(); \
+		if (latchVBlank == snes_vblank_count) { \
+			pads[0] = padLatch[0]; \
+			pads[1] = padLatch[1]; \
+		} \
+	}
+#endif /* not USE_REPLAY and not REC_REPLAY and not BENCH */
 
 
 /**
- * Set the tiles of a 16x16 game field element.
+ * Queues the 16x16 game field element at the given `cellMap` index for the
+ * render stage (see `renderCells()`) unless it is already queued.
  *
- * @param field - upper left game field tile pointer
- * @param offset - tile index base offset
+ * @param cell - `cellMap` index
  */
-#define setField(field, offset) \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x00); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x01); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x20); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x21); \
-	(field)[0x00] = (uint8_t)((offset) + 0x00); \
-	(field)[0x01] = (uint8_t)((offset) + 0x01); \
-	(field)[0x20] = (uint8_t)((offset) + 0x10); \
-	(field)[0x21] = (uint8_t)((offset) + 0x11); \
-	refreshGameScreenLow = true;
+#define markCellDirty(cell) \
+	if ( ! (cellMap[cell] & CELL_DIRTY) ) { \
+		ASSERT_ARY_IDX(dirtyCells, dirtyCellCount); \
+		cellMap[cell] |= CELL_DIRTY; \
+		dirtyCells[dirtyCellCount] = (uint8_t)(cell); \
+		++dirtyCellCount; \
+	}
 
 
 /**
- * Set the tiles of a 16x16 game field element with both column interchanged.
+ * Starts the animation of the 16x16 game field element at the given
+ * `cellMap` index. The element is being added to `aniList` if it was not
+ * animated before.
  *
- * @param field - upper left game field tile pointer
- * @param offset - tile index base offset
+ * @param cell - `cellMap` index
  */
-#define setFieldFlippedX(field, offset) \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x00); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x01); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x20); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x21); \
-	(field)[0x00] = (uint8_t)((offset) + 0x01); \
-	(field)[0x01] = (uint8_t)((offset) + 0x00); \
-	(field)[0x20] = (uint8_t)((offset) + 0x11); \
-	(field)[0x21] = (uint8_t)((offset) + 0x10); \
-	refreshGameScreenLow = true;
+#define startCellAnimation(cell) \
+	ASSERT_ARY_IDX(aniCell, cell); \
+	ASSERT_ARY_IDX(ttlCell, cell); \
+	if (aniCell[cell] == 0) { \
+		ASSERT_ARY_IDX(aniList, aniListCount); \
+		aniList[aniListCount] = (uint8_t)(cell); \
+		++aniListCount; \
+	} \
+	aniCell[cell] = 4; \
+	ttlCell[cell] = EXPLOSION_ANIMATION;
 
 
 /**
- * Set the tiles of a 16x16 game field element with both rows interchanged.
+ * Sets the type and graphic of a 16x16 game field element.
+ * The explosion ray lengths are updated if the element starts or ends
+ * stopping explosions.
  *
- * @param field - upper left game field tile pointer
- * @param offset - tile index base offset
+ * @param cell - `cellMap` index
+ * @param type - field type (e.g. `FTYPE_BOMB_P1`)
+ * @param gfx - graphic variant (see `CELL_GFX`)
  */
-#define setFieldFlippedY(field, offset) \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x00); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x01); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x20); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x21); \
-	(field)[0x00] = (uint8_t)((offset) + 0x10); \
-	(field)[0x01] = (uint8_t)((offset) + 0x11); \
-	(field)[0x20] = (uint8_t)((offset) + 0x00); \
-	(field)[0x21] = (uint8_t)((offset) + 0x01); \
-	refreshGameScreenLow = true;
+#define setCell(cell, type, gfx) \
+	ASSERT_ARY_IDX(cellMap, cell); \
+	ASSERT_ARY_IDX(fTypeCell, type); \
+	if ( (cellMap[cell] ^ fTypeCell[type]) & CELL_STOP ) { \
+		cellMap[cell] ^= CELL_STOP; \
+		updateRays(cell); \
+	} \
+	cellMap[cell] = (uint8_t)(fTypeCell[type] | (cellMap[cell] & CELL_DIRTY)); \
+	cellGfx[cell] = (uint8_t)(gfx); \
+	markCellDirty(cell)
 
 
 /**
- * Set the tiles of a 16x16 game field element to its next frame.
+ * Clears a 16x16 game field element.
  *
- * @param field - upper left game field tile pointer
+ * @param cell - `cellMap` index
  */
-#define nextFieldFrame(field) \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x00); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x01); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x20); \
-	ASSERT_ARY_PTR(gameFieldLow, field + 0x21); \
-	(field)[0x00] = (uint8_t)((field)[0x00] + 2); \
-	(field)[0x01] = (uint8_t)((field)[0x01] + 2); \
-	(field)[0x20] = (uint8_t)((field)[0x20] + 2); \
-	(field)[0x21] = (uint8_t)((field)[0x21] + 2); \
-	refreshGameScreenLow = true;
+#define clearCell(cell) \
+	setCell(cell, FTYPE_EMPTY, 0)
 
 
 /**
- * Set the tiles of a 16x16 game field attributes.
+ * Sets a 16x16 game field element to its next animation frame.
  *
- * @param field - upper left game field tile attribute pointer
- * @param attr - attribute value
+ * @param cell - `cellMap` index
  */
-#define setFieldAttr(field, attr) \
-	ASSERT_ARY_PTR(gameFieldHigh, field + 0x00); \
-	ASSERT_ARY_PTR(gameFieldHigh, field + 0x01); \
-	ASSERT_ARY_PTR(gameFieldHigh, field + 0x20); \
-	ASSERT_ARY_PTR(gameFieldHigh, field + 0x21); \
-	(field)[0x00] = (uint8_t)(attr); \
-	(field)[0x01] = (uint8_t)(attr); \
-	(field)[0x20] = (uint8_t)(attr); \
-	(field)[0x21] = (uint8_t)(attr); \
-	refreshGameScreenHigh = true;
+#define nextCellFrame(cell) \
+	ASSERT_ARY_IDX(cellGfx, cell); \
+	++cellGfx[cell]; \
+	markCellDirty(cell)
 
 
 
@@ -335,7 +548,8 @@ enum {
 	O_TIME,
 	O_DROPRATE,
 	O_BOMBS,
-	O_RANGE
+	O_RANGE,
+	O_HUMANS
 };
 
 
@@ -390,7 +604,7 @@ enum {
 };
 
 
-/** Mapped index of the foreground 2 tiles for faster categorization. See `fTypeMap`. */
+/** Game field element types. See `cellMap`. Needs to match with utility.asm. */
 enum {
 	FTYPE_EMPTY,
 	FTYPE_BOMB_P1,
@@ -404,32 +618,96 @@ enum {
 };
 
 
-/** Possible values for `winner`. */
+/** Flags of a `cellMap` entry in addition to its `FTYPE` (see `fTypeCell`). Needs to match with utility.asm. */
 enum {
-	WINNER_NA = 0,
-	WINNER_P1 = 1,
-	WINNER_P2 = 2,
-	WINNER_DRAW = WINNER_P1 | WINNER_P2
+	CELL_TYPE    = 0x0F, /**< mask of the `FTYPE` value */
+	CELL_STOP    = 0x10, /**< stops explosions (see `rayLeft`) */
+	CELL_DIRTY   = 0x20, /**< queued in `dirtyCells` for the render stage */
+	CELL_TOUCH   = 0x40, /**< power-up or flame which takes effect if touched by a player */
+	CELL_BLOCKED = 0x80  /**< cannot be entered by a player (with the exception of the bomb just dropped) */
 };
 
 
-/** Structure holding a single dropped bomb entry. */
-typedef struct {
-	uint8_t x; /**< upper left tile in x coordinate */
-	uint8_t y; /**< upper left tile in y coordinate */
-	uint8_t ttl; /**< time to live in 1/10s units */
-	uint8_t curFrame; /**< current animation frame index (0..1) */
-	uint8_t ttlFrame; /**< time to live until the next animation frame is being shown in 1/10s units */
-} tBombField;
+/** Explosion shape of a `FTYPE_FLAME` game field element (see `CELL_GFX`). Needs to match with utility.asm. */
+enum {
+	SHAPE_MID,    /**< explosion center */
+	SHAPE_PART_X, /**< horizontal explosion part */
+	SHAPE_END_X,  /**< horizontal explosion end */
+	SHAPE_PART_Y, /**< vertical explosion part */
+	SHAPE_END_Y   /**< vertical explosion end */
+};
+
+
+/** Flags of a `cellGfx` entry (same bits as in `TILE_ATTR`). Needs to match with utility.asm. */
+enum {
+	GFX_FLIP_X = 0x40, /**< mirror horizontally */
+	GFX_FLIP_Y = 0x80  /**< mirror vertically */
+};
+
+
+/** Value of `winner` while the match is running. Else it holds the bit mask of the winning players (see `tPlayer.bit`). */
+enum {
+	WINNER_NA = 0
+};
 
 
 /**
- * Structure holding a single entry of a triggered bomb (from a chain reaction).
+ * Phases of the work of a single 10 Hz tick given as value of `framesUntil10Hz`
+ * of the frame they are being performed in. This avoids a single frame with
+ * the costs of all tick related work. The order within a tick is kept.
  */
-typedef struct {
-	uint8_t range; /**< range of the triggered bomb */
-	tBombField * entry; /**< reference to the triggered bomb entry */
-} tTriggeredBomb;
+enum {
+	TICK_ANIMATION  = 0,          /**< game time, player and game field animations (the tick itself) */
+	TICK_BOMBS      = FP10HZ - 1, /**< bomb animation and timeouts (one frame after the tick) */
+	TICK_EXPLOSIONS = FP10HZ - 2  /**< explosions and chain reactions (two frames after the tick) */
+};
+
+
+#ifdef BENCH
+/** Benchmark scenarios (see `benchResult`). */
+enum {
+	BENCH_BOMBS,  /**< all bombs of all players with maximum range exploding on the same tick */
+	BENCH_CHAIN,  /**< all bombs of all players triggered by a single bomb in a chain reaction */
+	BENCH_BRICKS, /**< all bricked walls breaking on the same tick (drop rate 100%) */
+	BENCH_BOOTS,  /**< all players running with speed boots */
+	BENCH_CPU     /**< all players controlled by the CPU */
+};
+#endif /* BENCH */
+
+
+/** Profiler sections (see `PROFILE_BEGIN`; also defines the raster bar color). */
+enum {
+	PROF_GAME,   /**< `handleGame()` (red) */
+	PROF_TICK,   /**< 10 Hz tick within `handleGame()` (green) */
+	PROF_PLAYER, /**< `handlePlayer()` for all players (blue) */
+	PROF_RENDER, /**< `renderCells()` (yellow) */
+	PROF_VBLANK, /**< VRAM updates within `handleVBlank()` (cyan) */
+	PROF_INPUT,  /**< span from the pad sampling in `handleGame()` to its VRAM commit in `handleVBlank()` */
+	PROF_CPU,    /**< danger map and path search of the CPU players within `handleGame()` (white) */
+	PROF_IDLE    /**< idle tasks within `WaitForVBlank()` (gray) */
+};
+
+
+#if defined(HAS_BGM) || defined(HAS_SFX)
+/** Audio boot stages performed one per frame by `bootAudioStep()` (see `audioStage`). */
+enum {
+	AUDIO_BOOT,  /**< upload the sound driver to the SPC700 */
+	AUDIO_BANKS, /**< register the soundbanks */
+	AUDIO_SFX,   /**< allocate the sound region and set the sound effect entry */
+	AUDIO_BGM,   /**< upload the background music module */
+	AUDIO_PLAY,  /**< start the background music */
+	AUDIO_READY  /**< sound driver running and processed once per frame */
+};
+#endif /* HAS_BGM or HAS_SFX */
+
+
+#ifdef HAS_SFX
+/** Sound effects (index into `sfxInfo` and the sound table of the sound driver). */
+enum {
+	SFX_EXPLOSION, /**< bomb explosion */
+	SFX_COUNT
+};
+#endif /* HAS_SFX */
 
 
 /** Structure holding the needed parameters for a single player. */
@@ -447,11 +725,55 @@ typedef struct {
 	uint8_t maxBombs; /**< maximum number of bombs */
 	uint8_t bombs; /**< remaining number of bombs */
 	uint8_t running; /**< time remaining running */
-	tBombField bombList[MAX_BOMBS]; /**< list of active bombs (if `.ttl` > 0) */
-	uint8_t lastBombIdx; /**< index to `bombList` for the most recently dropped bomb (if still at that position) */
+	uint8_t lastBombIdx; /**< index to `bombPool` for the most recently dropped bomb (if still at that position) */
+	uint8_t sprite; /**< sprite of the player (see `allocSprite()`) */
+	uint8_t nr; /**< index within `players` */
+	uint8_t bit; /**< bit of the player in `alivePlayers`, `hitPlayers` and `winner` */
+	uint8_t bombType; /**< game field type of the dropped bombs (players 3 and 4 share those of player 1 and 2) */
 } tPlayer;
 
 
+/** Structure holding the decision of a single CPU player (see `searchStep()` and `cpuPad()`). */
+typedef struct {
+	uint8_t path[CPU_PATH_LEN + 1]; /**< cells to walk through starting with the cell the decision was made at */
+	uint8_t pathLen; /**< number of valid items in `path` */
+	uint8_t pathPos; /**< `path` index of the cell to walk to next */
+	uint8_t bombCell; /**< cell to drop a bomb at or `INVALID_CELL` */
+} tCpu;
+
+
+/** Structure holding the initialized game field of a match for a rematch (see `saveMatch()`). */
+typedef struct {
+	uint8_t cellMap[CELL_COUNT]; /**< `cellMap` without `CELL_DIRTY` */
+	uint8_t cellGfx[CELL_COUNT]; /**< `cellGfx` */
+	uint8_t rayLeft[CELL_COUNT]; /**< `rayLeft` */
+	uint8_t rayRight[CELL_COUNT]; /**< `rayRight` */
+	uint8_t rayUp[CELL_COUNT]; /**< `rayUp` */
+	uint8_t rayDown[CELL_COUNT]; /**< `rayDown` */
+	uint8_t hudField[HUD_ROWS * HUD_COLS]; /**< `hudField` */
+} tMatch;
+
+
+/** Structure holding a single dropped bomb entry of `bombPool`. */
+typedef struct {
+	tPlayer * owner; /**< player which dropped the bomb or NULL if unused */
+	uint16_t explodeTick; /**< `counter10Hz` value at which the bomb explodes */
+	uint8_t cell; /**< `cellMap` index of the bomb */
+	uint8_t slot; /**< `bombWheel` slot which holds this bomb */
+	uint8_t prev; /**< previous bomb in the same `bombWheel` slot or `INVALID_BOMB` */
+	uint8_t next; /**< next bomb in the same `bombWheel` slot or `INVALID_BOMB` */
+} tBombField;
+
+
+/**
+ * Structure holding a single entry of a triggered bomb (from a timeout or chain reaction).
+ */
+typedef struct {
+	uint8_t range; /**< range of the triggered bomb */
+	uint8_t idx; /**< `bombPool` index of the triggered bomb */
+} tTriggeredBomb;
+
+
 /** Structure holding the first animation frame index and horizontal mirroring information. */
 typedef struct {
 	uint8_t firstFrame; /**< first 16x16 frame of the sprite (e.g. ACT_DOWN) */
@@ -460,7 +782,42 @@ typedef struct {
 } tMoveAnimation;
 
 
+/** Run-length encoded pad values of a replay (see `replayData` and `replayBuffer`). */
+typedef struct {
+	uint16_t pad0; /**< value for `pads[0]` */
+	uint16_t pad1; /**< value for `pads[1]` */
+	uint16_t count; /**< number of main loop iterations with these values (0 marks the end) */
+} tReplayEntry;
+
+
+#ifdef HAS_SFX
+/** Structure holding the parameters of a single sound effect. */
+typedef struct {
+	uint8_t * data; /**< BRR sample data */
+	uint8_t * end; /**< end of the BRR sample data */
+	uint8_t priority; /**< effects with a higher priority interrupt the playing one */
+	uint8_t ticks; /**< playing time in 1/10s (voice stays busy for this time) */
+} tSfx;
+#endif /* HAS_SFX */
+
+
+/** Runs one bounded slice of deferrable work. Returns true if more work is pending. */
+typedef bool (*IdleFn)(void);
+
+
+/** Structure holding a deferrable task of `runIdleTasks()`. */
+typedef struct {
+	IdleFn run; /**< performs one slice of the task */
+	uint8_t lines; /**< estimated scanlines of one slice or 0 if the slice stops at `IDLE_END_LINE` by itself */
+} tIdleTask;
+
+
 /* forward declarations */
+static void runIdleTasks(void);
+static bool idleRandom(void);
+#if !defined(USE_REPLAY) && !defined(REC_REPLAY) && !defined(BENCH)
+static bool idleSearch(void);
+#endif /* not USE_REPLAY and not REC_REPLAY and not BENCH */
 void handleTitle(void);
 void handleOptions(void);
 void handleGame(void);
@@ -477,28 +834,46 @@ extern uint8_t SOUNDBANK__0, SOUNDBANK__1;
 /* sound effect (`data.asm`) */
 extern uint8_t sfx1[], sfx1End[];
 #endif /* HAS_SFX */
-/* title/options background (`data.asm`) */
-extern uint8_t bg1Tiles[], bg1TilesEnd[];
+/* title/options background (`data.asm`; `*Lz` compressed, maps decompressed to WRAM) */
+extern uint8_t bg1TilesLz[];
 extern uint8_t bg1Pal[], bg1PalEnd[];
-extern uint8_t bg1Map[], bg1MapEnd[];
+extern uint8_t bg1MapLz[], bg1Map[];
 /* field background (`data.asm`) */
-extern uint8_t bg2Map[], bg2MapEnd[];
+extern uint8_t bg2MapLz[], bg2Map[];
 /* credits foreground (`data.asm`) */
-extern uint8_t fg1Tiles[], fg1TilesEnd[];
+extern uint8_t fg1TilesLz[];
 extern uint8_t fg1Pal[], fg1PalEnd[];
-extern uint8_t fg1Map[], fg1MapEnd[];
+extern uint8_t fg1MapLz[], fg1Map[];
 /* options foreground (`data.asm`) */
-extern uint8_t optionsMap[], optionsMapEnd[];
+extern uint8_t optionsMapLz[], optionsMap[];
 /* field foreground (`data.asm`) */
-extern uint8_t fg2Tiles[], fg2TilesEnd[];
+extern uint8_t fg2TilesLz[];
 extern uint8_t fg2Pal[], fg2PalEnd[];
-extern uint8_t fieldMap[], fieldMapEnd[];
+extern uint8_t fieldMapLow[], fieldMapLowEnd[];
+extern uint8_t fieldMapHigh[], fieldMapHighEnd[];
 /* player 1/2 (`data.asm`) */
-extern uint8_t p12Tiles[], p12TilesEnd[];
+extern uint8_t p12TilesLz[];
 extern uint8_t p12Pal[], p12PalEnd[];
+#ifdef USE_REPLAY
+/* replay pad values (`data.asm`) */
+extern uint8_t replayData[], replayDataEnd[];
+#endif /* USE_REPLAY */
 
 
 /* global constants */
+#ifdef BENCH
+/* bomb positions for `BENCH_BOMBS` and `BENCH_CHAIN`; each bomb is in range of an earlier one */
+static const uint8_t benchBombCells[MAX_BOMBS * MAX_PLAYERS] = {
+	FIELD_CELL( 2,  4), FIELD_CELL( 6,  4), FIELD_CELL(10,  4), FIELD_CELL(14,  4), FIELD_CELL(18,  4),
+	FIELD_CELL(22,  4), FIELD_CELL(26,  4), FIELD_CELL( 2, 12), FIELD_CELL( 2, 16), /* player 1 */
+	FIELD_CELL(26, 12), FIELD_CELL(26, 16), FIELD_CELL( 2, 24), FIELD_CELL( 6, 24), FIELD_CELL(10, 24),
+	FIELD_CELL(14, 24), FIELD_CELL(18, 24), FIELD_CELL(22, 24), FIELD_CELL(26, 24), /* player 2 */
+	FIELD_CELL( 6,  8), FIELD_CELL(10,  8), FIELD_CELL(14,  8), FIELD_CELL(18,  8), FIELD_CELL(22,  8),
+	FIELD_CELL( 6, 12), FIELD_CELL(10, 12), FIELD_CELL(14, 12), FIELD_CELL(18, 12), /* player 3 */
+	FIELD_CELL(22, 12), FIELD_CELL( 6, 16), FIELD_CELL(10, 16), FIELD_CELL(14, 16), FIELD_CELL(18, 16),
+	FIELD_CELL(22, 16), FIELD_CELL( 6, 20), FIELD_CELL(10, 20), FIELD_CELL(14, 20)  /* player 4 */
+};
+#endif /* BENCH */
 static const VoidFn screenHandler[] = {
 	&handleTitle,
 	&handleOptions,
@@ -507,6 +882,21 @@ static const VoidFn screenHandler[] = {
 	&handleWinner
 };
 
+/* deferrable tasks in order of their priority (see `runIdleTasks()`) */
+static const tIdleTask idleTasks[] = {
+	{&idleRandom, 0},
+#if !defined(USE_REPLAY) && !defined(REC_REPLAY) && !defined(BENCH)
+	{&idleSearch, IDLE_SEARCH_LINES}
+#endif /* not USE_REPLAY and not REC_REPLAY and not BENCH */
+};
+
+#ifdef HAS_SFX
+/* sound effect parameters (see `SFX_EXPLOSION` etc.) */
+static const tSfx sfxInfo[SFX_COUNT] = {
+	{sfx1, sfx1End, 1, 6} /* SFX_EXPLOSION */
+};
+#endif /* HAS_SFX */
+
 static const uint8_t fg2NumText[] = {
 	CH_0,
 	CH_1,
@@ -524,149 +914,190 @@ static const uint8_t optionBelow[] = {
 	O_DROPRATE,
 	O_BOMBS,
 	O_RANGE,
-	O_RANGE
+	O_HUMANS,
+	O_HUMANS
 };
 
 static const uint8_t optionAbove[] = {
 	O_TIME,
 	O_TIME,
 	O_DROPRATE,
-	O_BOMBS
+	O_BOMBS,
+	O_RANGE
+};
+
+/** Start corners of player 3 and 4 which are kept free in four player matches (`cellMap` indices). */
+static const uint8_t startFields34[] = {
+	FIELD_CELL(22,  4),
+	FIELD_CELL(24,  4),
+	FIELD_CELL(26,  4),
+	FIELD_CELL(26,  6),
+	FIELD_CELL(26,  8),
+	FIELD_CELL( 2, 20),
+	FIELD_CELL( 2, 22),
+	FIELD_CELL( 2, 24),
+	FIELD_CELL( 4, 24),
+	FIELD_CELL( 6, 24)
 };
 
 /**
- * Contains the `gameFieldLow` and `aniField` index for each game
- * board field (upper left corner) in the game which can change.
+ * Contains the `cellMap` index for each game board field in
+ * the game which can change. All other fields are solid walls.
  */
-static const uint16_t fieldElemIndex[] = {
+static const uint8_t fieldElemIndex[] = {
 	/* blocks left untouched during field initialization (see `FIRST_FLEX_FIELD`) */
-	TILE_OFFSET_1( 2,  4),
-	TILE_OFFSET_1( 2,  6),
-	TILE_OFFSET_1( 2,  8),
-	TILE_OFFSET_1( 4,  4),
-	TILE_OFFSET_1( 6,  4),
-	TILE_OFFSET_1(22, 24),
-	TILE_OFFSET_1(24, 24),
-	TILE_OFFSET_1(26, 20),
-	TILE_OFFSET_1(26, 22),
-	TILE_OFFSET_1(26, 24),
+	FIELD_CELL( 2,  4),
+	FIELD_CELL( 2,  6),
+	FIELD_CELL( 2,  8),
+	FIELD_CELL( 4,  4),
+	FIELD_CELL( 6,  4),
+	FIELD_CELL(22, 24),
+	FIELD_CELL(24, 24),
+	FIELD_CELL(26, 20),
+	FIELD_CELL(26, 22),
+	FIELD_CELL(26, 24),
 
 	/* remaining blocks */
-	TILE_OFFSET_1( 2, 10),
-	TILE_OFFSET_1( 2, 12),
-	TILE_OFFSET_1( 2, 14),
-	TILE_OFFSET_1( 2, 16),
-	TILE_OFFSET_1( 2, 18),
-	TILE_OFFSET_1( 2, 20),
-	TILE_OFFSET_1( 2, 22),
-	TILE_OFFSET_1( 2, 24),
-
-	TILE_OFFSET_1( 4,  8),
-	TILE_OFFSET_1( 4, 12),
-	TILE_OFFSET_1( 4, 16),
-	TILE_OFFSET_1( 4, 20),
-	TILE_OFFSET_1( 4, 24),
-
-	TILE_OFFSET_1( 6,  6),
-	TILE_OFFSET_1( 6,  8),
-	TILE_OFFSET_1( 6, 10),
-	TILE_OFFSET_1( 6, 12),
-	TILE_OFFSET_1( 6, 14),
-	TILE_OFFSET_1( 6, 16),
-	TILE_OFFSET_1( 6, 18),
-	TILE_OFFSET_1( 6, 20),
-	TILE_OFFSET_1( 6, 22),
-	TILE_OFFSET_1( 6, 24),
-
-	TILE_OFFSET_1( 8,  4),
-	TILE_OFFSET_1( 8,  8),
-	TILE_OFFSET_1( 8, 12),
-	TILE_OFFSET_1( 8, 16),
-	TILE_OFFSET_1( 8, 20),
-	TILE_OFFSET_1( 8, 24),
-
-	TILE_OFFSET_1(10,  4),
-	TILE_OFFSET_1(10,  6),
-	TILE_OFFSET_1(10,  8),
-	TILE_OFFSET_1(10, 10),
-	TILE_OFFSET_1(10, 12),
-	TILE_OFFSET_1(10, 14),
-	TILE_OFFSET_1(10, 16),
-	TILE_OFFSET_1(10, 18),
-	TILE_OFFSET_1(10, 20),
-	TILE_OFFSET_1(10, 22),
-	TILE_OFFSET_1(10, 24),
-
-	TILE_OFFSET_1(12,  4),
-	TILE_OFFSET_1(12,  8),
-	TILE_OFFSET_1(12, 12),
-	TILE_OFFSET_1(12, 16),
-	TILE_OFFSET_1(12, 20),
-	TILE_OFFSET_1(12, 24),
-
-	TILE_OFFSET_1(14,  4),
-	TILE_OFFSET_1(14,  6),
-	TILE_OFFSET_1(14,  8),
-	TILE_OFFSET_1(14, 10),
-	TILE_OFFSET_1(14, 12),
-	TILE_OFFSET_1(14, 14),
-	TILE_OFFSET_1(14, 16),
-	TILE_OFFSET_1(14, 18),
-	TILE_OFFSET_1(14, 20),
-	TILE_OFFSET_1(14, 22),
-	TILE_OFFSET_1(14, 24),
-
-	TILE_OFFSET_1(16,  4),
-	TILE_OFFSET_1(16,  8),
-	TILE_OFFSET_1(16, 12),
-	TILE_OFFSET_1(16, 16),
-	TILE_OFFSET_1(16, 20),
-	TILE_OFFSET_1(16, 24),
-
-	TILE_OFFSET_1(18,  4),
-	TILE_OFFSET_1(18,  6),
-	TILE_OFFSET_1(18,  8),
-	TILE_OFFSET_1(18, 10),
-	TILE_OFFSET_1(18, 12),
-	TILE_OFFSET_1(18, 14),
-	TILE_OFFSET_1(18, 16),
-	TILE_OFFSET_1(18, 18),
-	TILE_OFFSET_1(18, 20),
-	TILE_OFFSET_1(18, 22),
-	TILE_OFFSET_1(18, 24),
-
-	TILE_OFFSET_1(20,  4),
-	TILE_OFFSET_1(20,  8),
-	TILE_OFFSET_1(20, 12),
-	TILE_OFFSET_1(20, 16),
-	TILE_OFFSET_1(20, 20),
-	TILE_OFFSET_1(20, 24),
-
-	TILE_OFFSET_1(22,  4),
-	TILE_OFFSET_1(22,  6),
-	TILE_OFFSET_1(22,  8),
-	TILE_OFFSET_1(22, 10),
-	TILE_OFFSET_1(22, 12),
-	TILE_OFFSET_1(22, 14),
-	TILE_OFFSET_1(22, 16),
-	TILE_OFFSET_1(22, 18),
-	TILE_OFFSET_1(22, 20),
-	TILE_OFFSET_1(22, 22),
-
-	TILE_OFFSET_1(24,  4),
-	TILE_OFFSET_1(24,  8),
-	TILE_OFFSET_1(24, 12),
-	TILE_OFFSET_1(24, 16),
-	TILE_OFFSET_1(24, 20),
-
-	TILE_OFFSET_1(26,  4),
-	TILE_OFFSET_1(26,  6),
-	TILE_OFFSET_1(26,  8),
-	TILE_OFFSET_1(26, 10),
-	TILE_OFFSET_1(26, 12),
-	TILE_OFFSET_1(26, 14),
-	TILE_OFFSET_1(26, 16),
-	TILE_OFFSET_1(26, 18)
+	FIELD_CELL( 2, 10),
+	FIELD_CELL( 2, 12),
+	FIELD_CELL( 2, 14),
+	FIELD_CELL( 2, 16),
+	FIELD_CELL( 2, 18),
+	FIELD_CELL( 2, 20),
+	FIELD_CELL( 2, 22),
+	FIELD_CELL( 2, 24),
+
+	FIELD_CELL( 4,  8),
+	FIELD_CELL( 4, 12),
+	FIELD_CELL( 4, 16),
+	FIELD_CELL( 4, 20),
+	FIELD_CELL( 4, 24),
+
+	FIELD_CELL( 6,  6),
+	FIELD_CELL( 6,  8),
+	FIELD_CELL( 6, 10),
+	FIELD_CELL( 6, 12),
+	FIELD_CELL( 6, 14),
+	FIELD_CELL( 6, 16),
+	FIELD_CELL( 6, 18),
+	FIELD_CELL( 6, 20),
+	FIELD_CELL( 6, 22),
+	FIELD_CELL( 6, 24),
+
+	FIELD_CELL( 8,  4),
+	FIELD_CELL( 8,  8),
+	FIELD_CELL( 8, 12),
+	FIELD_CELL( 8, 16),
+	FIELD_CELL( 8, 20),
+	FIELD_CELL( 8, 24),
+
+	FIELD_CELL(10,  4),
+	FIELD_CELL(10,  6),
+	FIELD_CELL(10,  8),
+	FIELD_CELL(10, 10),
+	FIELD_CELL(10, 12),
+	FIELD_CELL(10, 14),
+	FIELD_CELL(10, 16),
+	FIELD_CELL(10, 18),
+	FIELD_CELL(10, 20),
+	FIELD_CELL(10, 22),
+	FIELD_CELL(10, 24),
+
+	FIELD_CELL(12,  4),
+	FIELD_CELL(12,  8),
+	FIELD_CELL(12, 12),
+	FIELD_CELL(12, 16),
+	FIELD_CELL(12, 20),
+	FIELD_CELL(12, 24),
+
+	FIELD_CELL(14,  4),
+	FIELD_CELL(14,  6),
+	FIELD_CELL(14,  8),
+	FIELD_CELL(14, 10),
+	FIELD_CELL(14, 12),
+	FIELD_CELL(14, 14),
+	FIELD_CELL(14, 16),
+	FIELD_CELL(14, 18),
+	FIELD_CELL(14, 20),
+	FIELD_CELL(14, 22),
+	FIELD_CELL(14, 24),
+
+	FIELD_CELL(16,  4),
+	FIELD_CELL(16,  8),
+	FIELD_CELL(16, 12),
+	FIELD_CELL(16, 16),
+	FIELD_CELL(16, 20),
+	FIELD_CELL(16, 24),
+
+	FIELD_CELL(18,  4),
+	FIELD_CELL(18,  6),
+	FIELD_CELL(18,  8),
+	FIELD_CELL(18, 10),
+	FIELD_CELL(18, 12),
+	FIELD_CELL(18, 14),
+	FIELD_CELL(18, 16),
+	FIELD_CELL(18, 18),
+	FIELD_CELL(18, 20),
+	FIELD_CELL(18, 22),
+	FIELD_CELL(18, 24),
+
+	FIELD_CELL(20,  4),
+	FIELD_CELL(20,  8),
+	FIELD_CELL(20, 12),
+	FIELD_CELL(20, 16),
+	FIELD_CELL(20, 20),
+	FIELD_CELL(20, 24),
+
+	FIELD_CELL(22,  4),
+	FIELD_CELL(22,  6),
+	FIELD_CELL(22,  8),
+	FIELD_CELL(22, 10),
+	FIELD_CELL(22, 12),
+	FIELD_CELL(22, 14),
+	FIELD_CELL(22, 16),
+	FIELD_CELL(22, 18),
+	FIELD_CELL(22, 20),
+	FIELD_CELL(22, 22),
+
+	FIELD_CELL(24,  4),
+	FIELD_CELL(24,  8),
+	FIELD_CELL(24, 12),
+	FIELD_CELL(24, 16),
+	FIELD_CELL(24, 20),
+
+	FIELD_CELL(26,  4),
+	FIELD_CELL(26,  6),
+	FIELD_CELL(26,  8),
+	FIELD_CELL(26, 10),
+	FIELD_CELL(26, 12),
+	FIELD_CELL(26, 14),
+	FIELD_CELL(26, 16),
+	FIELD_CELL(26, 18),
+
+#ifdef USE_LARGE_ARENA
+	/* rows below the screen */
+	FIELD_CELL( 2, 26),
+	FIELD_CELL( 6, 26),
+	FIELD_CELL(10, 26),
+	FIELD_CELL(14, 26),
+	FIELD_CELL(18, 26),
+	FIELD_CELL(22, 26),
+	FIELD_CELL(26, 26),
+
+	FIELD_CELL( 2, 28),
+	FIELD_CELL( 4, 28),
+	FIELD_CELL( 6, 28),
+	FIELD_CELL( 8, 28),
+	FIELD_CELL(10, 28),
+	FIELD_CELL(12, 28),
+	FIELD_CELL(14, 28),
+	FIELD_CELL(16, 28),
+	FIELD_CELL(18, 28),
+	FIELD_CELL(20, 28),
+	FIELD_CELL(22, 28),
+	FIELD_CELL(24, 28),
+	FIELD_CELL(26, 28),
+#endif /* USE_LARGE_ARENA */
 };
 
 
@@ -679,6 +1110,15 @@ static const uint8_t playerTileMap[] = {
 	0x0C, 0x0E, 0x0C, 0x20  /* ACT_SIDE */
 };
 
+/* start position in pixels and `hudField` index of the bomb count and range of each player */
+static const uint8_t playerStartX[MAX_PLAYERS] = {2 * 8, 26 * 8, 26 * 8, 2 * 8};
+static const uint8_t playerStartY[MAX_PLAYERS] = {4 * 8, 24 * 8, 4 * 8, 24 * 8};
+static const uint8_t playerHudBombs[MAX_PLAYERS] = {TILE_OFFSET(3, 1), TILE_OFFSET(23, 1), TILE_OFFSET(3, 0), TILE_OFFSET(23, 0)};
+static const uint8_t playerHudRange[MAX_PLAYERS] = {TILE_OFFSET(7, 1), TILE_OFFSET(27, 1), TILE_OFFSET(7, 0), TILE_OFFSET(27, 0)};
+
+/* `hudField` index of the player label of each winner on the winner screen */
+static const uint8_t winnerHud[MAX_PLAYERS] = {TILE_OFFSET(13, 0), TILE_OFFSET(13, 1), TILE_OFFSET(11, 0), TILE_OFFSET(11, 1)};
+
 
 /**
  * Maps the delta movement to the corresponding animation frame.
@@ -700,242 +1140,169 @@ static const tMoveAnimation moveAni[] = {
 
 
 /**
- * Maps the foreground 2 tile index to a field type enumeration value
- * for faster categorization.
- */
-static const uint8_t fTypeMap[] = {
-	FTYPE_EMPTY, /* 0x00 */
-	FTYPE_EMPTY, /* 0x01 */
-	FTYPE_EMPTY, /* 0x02 */
-	FTYPE_EMPTY, /* 0x03 */
-	FTYPE_EMPTY, /* 0x04 */
-	FTYPE_EMPTY, /* 0x05 */
-	FTYPE_EMPTY, /* 0x06 */
-	FTYPE_EMPTY, /* 0x07 */
-	FTYPE_BOMB_P1, /* 0x08 */
-	FTYPE_BOMB_P1, /* 0x09 */
-	FTYPE_BOMB_P1, /* 0x0A */
-	FTYPE_BOMB_P1, /* 0x0B */
-	FTYPE_BOMB_P2, /* 0x0C */
-	FTYPE_BOMB_P2, /* 0x0D */
-	FTYPE_BOMB_P2, /* 0x0E */
-	FTYPE_BOMB_P2, /* 0x0F */
-	FTYPE_EMPTY, /* 0x10 */
-	FTYPE_EMPTY, /* 0x11 */
-	FTYPE_EMPTY, /* 0x12 */
-	FTYPE_EMPTY, /* 0x13 */
-	FTYPE_EMPTY, /* 0x14 */
-	FTYPE_EMPTY, /* 0x15 */
-	FTYPE_EMPTY, /* 0x16 */
-	FTYPE_EMPTY, /* 0x17 */
-	FTYPE_BOMB_P1, /* 0x18 */
-	FTYPE_BOMB_P1, /* 0x19 */
-	FTYPE_BOMB_P1, /* 0x1A */
-	FTYPE_BOMB_P1, /* 0x1B */
-	FTYPE_BOMB_P2, /* 0x1C */
-	FTYPE_BOMB_P2, /* 0x1D */
-	FTYPE_BOMB_P2, /* 0x1E */
-	FTYPE_BOMB_P2, /* 0x1F */
-	FTYPE_FLAME, /* 0x20 */
-	FTYPE_FLAME, /* 0x21 */
-	FTYPE_FLAME, /* 0x22 */
-	FTYPE_FLAME, /* 0x23 */
-	FTYPE_FLAME, /* 0x24 */
-	FTYPE_FLAME, /* 0x25 */
-	FTYPE_FLAME, /* 0x26 */
-	FTYPE_FLAME, /* 0x27 */
-	FTYPE_PU_BOMB, /* 0x28 */
-	FTYPE_PU_BOMB, /* 0x29 */
-	FTYPE_PU_RANGE, /* 0x2A */
-	FTYPE_PU_RANGE, /* 0x2B */
-	FTYPE_PU_SPEED, /* 0x2C */
-	FTYPE_PU_SPEED, /* 0x2D */
-	FTYPE_EMPTY, /* 0x2E */
-	FTYPE_EMPTY, /* 0x2F */
-	FTYPE_FLAME, /* 0x30 */
-	FTYPE_FLAME, /* 0x31 */
-	FTYPE_FLAME, /* 0x32 */
-	FTYPE_FLAME, /* 0x33 */
-	FTYPE_FLAME, /* 0x34 */
-	FTYPE_FLAME, /* 0x35 */
-	FTYPE_FLAME, /* 0x36 */
-	FTYPE_FLAME, /* 0x37 */
-	FTYPE_PU_BOMB, /* 0x38 */
-	FTYPE_PU_BOMB, /* 0x39 */
-	FTYPE_PU_RANGE, /* 0x3A */
-	FTYPE_PU_RANGE, /* 0x3B */
-	FTYPE_PU_SPEED, /* 0x3C */
-	FTYPE_PU_SPEED, /* 0x3D */
-	FTYPE_EMPTY, /* 0x3E */
-	FTYPE_EMPTY, /* 0x3F */
-	FTYPE_FLAME, /* 0x40 */
-	FTYPE_FLAME, /* 0x41 */
-	FTYPE_FLAME, /* 0x42 */
-	FTYPE_FLAME, /* 0x43 */
-	FTYPE_FLAME, /* 0x44 */
-	FTYPE_FLAME, /* 0x45 */
-	FTYPE_FLAME, /* 0x46 */
-	FTYPE_FLAME, /* 0x47 */
-	FTYPE_EMPTY, /* 0x48 */
-	FTYPE_EMPTY, /* 0x49 */
-	FTYPE_EMPTY, /* 0x4A */
-	FTYPE_EMPTY, /* 0x4B */
-	FTYPE_EMPTY, /* 0x4C */
-	FTYPE_EMPTY, /* 0x4D */
-	FTYPE_EMPTY, /* 0x4E */
-	FTYPE_EMPTY, /* 0x4F */
-	FTYPE_FLAME, /* 0x50 */
-	FTYPE_FLAME, /* 0x51 */
-	FTYPE_FLAME, /* 0x52 */
-	FTYPE_FLAME, /* 0x53 */
-	FTYPE_FLAME, /* 0x54 */
-	FTYPE_FLAME, /* 0x55 */
-	FTYPE_FLAME, /* 0x56 */
-	FTYPE_FLAME, /* 0x57 */
-	FTYPE_EMPTY, /* 0x58 */
-	FTYPE_EMPTY, /* 0x59 */
-	FTYPE_EMPTY, /* 0x5A */
-	FTYPE_EMPTY, /* 0x5B */
-	FTYPE_EMPTY, /* 0x5C */
-	FTYPE_EMPTY, /* 0x5D */
-	FTYPE_EMPTY, /* 0x5E */
-	FTYPE_EMPTY, /* 0x5F */
-	FTYPE_FLAME, /* 0x60 */
-	FTYPE_FLAME, /* 0x61 */
-	FTYPE_FLAME, /* 0x62 */
-	FTYPE_FLAME, /* 0x63 */
-	FTYPE_FLAME, /* 0x64 */
-	FTYPE_FLAME, /* 0x65 */
-	FTYPE_FLAME, /* 0x66 */
-	FTYPE_FLAME, /* 0x67 */
-	FTYPE_SOLID, /* 0x68 */
-	FTYPE_SOLID, /* 0x69 */
-	FTYPE_BRICKED, /* 0x6A */
-	FTYPE_BRICKED, /* 0x6B */
-	FTYPE_BRICKED, /* 0x6C */
-	FTYPE_BRICKED, /* 0x6D */
-	FTYPE_BRICKED, /* 0x6E */
-	FTYPE_BRICKED, /* 0x6F */
-	FTYPE_FLAME, /* 0x70 */
-	FTYPE_FLAME, /* 0x71 */
-	FTYPE_FLAME, /* 0x72 */
-	FTYPE_FLAME, /* 0x73 */
-	FTYPE_FLAME, /* 0x74 */
-	FTYPE_FLAME, /* 0x75 */
-	FTYPE_FLAME, /* 0x76 */
-	FTYPE_FLAME, /* 0x77 */
-	FTYPE_SOLID, /* 0x78 */
-	FTYPE_SOLID, /* 0x79 */
-	FTYPE_BRICKED, /* 0x7A */
-	FTYPE_BRICKED, /* 0x7B */
-	FTYPE_BRICKED, /* 0x7C */
-	FTYPE_BRICKED, /* 0x7D */
-	FTYPE_BRICKED, /* 0x7E */
-	FTYPE_BRICKED, /* 0x7F */
-	FTYPE_FLAME, /* 0x80 */
-	FTYPE_FLAME, /* 0x81 */
-	FTYPE_FLAME, /* 0x82 */
-	FTYPE_FLAME, /* 0x83 */
-	FTYPE_FLAME, /* 0x84 */
-	FTYPE_FLAME, /* 0x85 */
-	FTYPE_FLAME, /* 0x86 */
-	FTYPE_FLAME, /* 0x87 */
-	FTYPE_EMPTY, /* 0x88 */
-	FTYPE_EMPTY, /* 0x89 */
-	FTYPE_EMPTY, /* 0x8A */
-	FTYPE_EMPTY, /* 0x8B */
-	FTYPE_EMPTY, /* 0x8C */
-	FTYPE_EMPTY, /* 0x8D */
-	FTYPE_EMPTY, /* 0x8E */
-	FTYPE_EMPTY, /* 0x8F */
-	FTYPE_FLAME, /* 0x90 */
-	FTYPE_FLAME, /* 0x91 */
-	FTYPE_FLAME, /* 0x92 */
-	FTYPE_FLAME, /* 0x93 */
-	FTYPE_FLAME, /* 0x94 */
-	FTYPE_FLAME, /* 0x95 */
-	FTYPE_FLAME, /* 0x96 */
-	FTYPE_FLAME, /* 0x97 */
-	FTYPE_EMPTY, /* 0x98 */
-	FTYPE_EMPTY, /* 0x99 */
-	FTYPE_EMPTY, /* 0x9A */
-	FTYPE_EMPTY, /* 0x9B */
-	FTYPE_EMPTY, /* 0x9C */
-	FTYPE_EMPTY, /* 0x9D */
-	FTYPE_EMPTY, /* 0x9E */
-	FTYPE_EMPTY, /* 0x9F */
-	FTYPE_FLAME, /* 0xA0 */
-	FTYPE_FLAME, /* 0xA1 */
-	FTYPE_FLAME, /* 0xA2 */
-	FTYPE_FLAME, /* 0xA3 */
-	FTYPE_FLAME, /* 0xA4 */
-	FTYPE_FLAME, /* 0xA5 */
-	FTYPE_FLAME, /* 0xA6 */
-	FTYPE_FLAME, /* 0xA7 */
-	FTYPE_EMPTY, /* 0xA8 */
-	FTYPE_EMPTY, /* 0xA9 */
-	FTYPE_EMPTY, /* 0xAA */
-	FTYPE_EMPTY, /* 0xAB */
-	FTYPE_EMPTY, /* 0xAC */
-	FTYPE_EMPTY, /* 0xAD */
-	FTYPE_EMPTY, /* 0xAE */
-	FTYPE_EMPTY, /* 0xAF */
-	FTYPE_FLAME, /* 0xB0 */
-	FTYPE_FLAME, /* 0xB1 */
-	FTYPE_FLAME, /* 0xB2 */
-	FTYPE_FLAME, /* 0xB3 */
-	FTYPE_FLAME, /* 0xB4 */
-	FTYPE_FLAME, /* 0xB5 */
-	FTYPE_FLAME, /* 0xB6 */
-	FTYPE_FLAME, /* 0xB7 */
-	FTYPE_EMPTY, /* 0xB8 */
-	FTYPE_EMPTY, /* 0xB9 */
-	FTYPE_EMPTY, /* 0xBA */
-	FTYPE_EMPTY, /* 0xBB */
-	FTYPE_EMPTY, /* 0xBC */
-	FTYPE_EMPTY, /* 0xBD */
-	FTYPE_EMPTY, /* 0xBE */
-	FTYPE_EMPTY  /* 0xBF */
+ * Maps each field type enumeration value to its `cellMap` entry.
+ */
+static const uint8_t fTypeCell[] = {
+	FTYPE_EMPTY,                     /* FTYPE_EMPTY */
+	FTYPE_BOMB_P1  | CELL_BLOCKED | CELL_STOP, /* FTYPE_BOMB_P1 */
+	FTYPE_BOMB_P2  | CELL_BLOCKED | CELL_STOP, /* FTYPE_BOMB_P2 */
+	FTYPE_PU_BOMB  | CELL_TOUCH | CELL_STOP,   /* FTYPE_PU_BOMB */
+	FTYPE_PU_RANGE | CELL_TOUCH | CELL_STOP,   /* FTYPE_PU_RANGE */
+	FTYPE_PU_SPEED | CELL_TOUCH | CELL_STOP,   /* FTYPE_PU_SPEED */
+	FTYPE_SOLID    | CELL_BLOCKED | CELL_STOP, /* FTYPE_SOLID */
+	FTYPE_BRICKED  | CELL_BLOCKED | CELL_STOP, /* FTYPE_BRICKED */
+	FTYPE_FLAME    | CELL_TOUCH                /* FTYPE_FLAME */
+};
+
+
+/**
+ * Maps each field type enumeration value to the upper left foreground 2 tile
+ * index of its first animation frame (see `renderCells()`).
+ */
+static const uint8_t fTypeTile[] = {
+	FIELD_EMPTY,    /* FTYPE_EMPTY */
+	FIELD_BOMB_P1,  /* FTYPE_BOMB_P1 */
+	FIELD_BOMB_P2,  /* FTYPE_BOMB_P2 */
+	FIELD_PU_BOMB,  /* FTYPE_PU_BOMB */
+	FIELD_PU_RANGE, /* FTYPE_PU_RANGE */
+	FIELD_PU_SPEED, /* FTYPE_PU_SPEED */
+	FIELD_SOLID,    /* FTYPE_SOLID */
+	FIELD_BRICKED,  /* FTYPE_BRICKED */
+	FIELD_EXPL_MID  /* FTYPE_FLAME (see `shapeTile`) */
+};
+
+
+/**
+ * Maps each explosion shape to the upper left foreground 2 tile index of its
+ * first animation frame (see `renderCells()`).
+ */
+static const uint8_t shapeTile[] = {
+	FIELD_EXPL_MID,    /* SHAPE_MID */
+	FIELD_EXPL_PART_X, /* SHAPE_PART_X */
+	FIELD_EXPL_END_X,  /* SHAPE_END_X */
+	FIELD_EXPL_PART_Y, /* SHAPE_PART_Y */
+	FIELD_EXPL_END_Y   /* SHAPE_END_Y */
 };
 
 
 /* global variables */
-static uint8_t i, j, j2;             /* 8-bit loop variables */
-static uint16_t k, m;                /* 16-bit loop variables */
 static uint16_t gameOver;            /* time remaining until the end of the game in seconds */
-static uint8_t winner;               /* hold the winner or 0 if not yet decided */
+static uint8_t winner;               /* bit mask of the winning players or 0 if not yet decided */
 static uint8_t screen, option;       /* current screen/option */
-static uint16_t pad0, pad1;          /* current pad values */
+static uint16_t pads[MAX_PLAYERS];   /* current pad values */
+static uint16_t latchVBlank;         /* `snes_vblank_count` at the start of `padsLatch()` (see `latchPads()`) */
 static uint16_t * pausePad;          /* pad that issued the game pause */
-static tPlayer p1, p2;               /* player specific parameters */
-static tTriggeredBomb bombChain[MAX_BOMBS * 2]; /* list of chain triggered bombs */
+static tPlayer players[MAX_PLAYERS]; /* player specific parameters */
+static tPlayer * curPlayer;          /* current `players` entry in loops over all players */
+static uint8_t playerIdx;            /* current `players` index in loops over all players */
+static uint8_t playerCount;          /* number of players in the match (2, or 4 with a multitap) */
+static uint8_t alivePlayers;         /* bit mask of the players still in the match (see `tPlayer.bit`) */
+static uint8_t hitPlayers;           /* bit mask of the players hit by an explosion within the current frame */
+static uint8_t offsetIdx;            /* `players` index within `setSpritesOffsetX()` (also called by the VBlank handler) */
+static uint8_t cpuPlayers;           /* bit mask of the players controlled by the CPU (see `humanPlayers`) */
+static tCpu cpus[MAX_PLAYERS];       /* decisions of the CPU players (same index as in `players`) */
+static tCpu * cpu;                   /* current `cpus` entry */
+static tBombField bombPool[MAX_BOMB_POOL]; /* dropped bombs of all players */
+static tBombField * bomb;            /* current `bombPool` entry */
+static uint8_t bombFree[MAX_BOMB_POOL]; /* stack of unused `bombPool` indices */
+static uint8_t bombFreeCount;        /* number of valid items in `bombFree` */
+static uint8_t bombWheel[BOMB_WHEEL_SIZE]; /* first `bombPool` index of the bombs with the next event at `counter10Hz` modulo `BOMB_WHEEL_SIZE` */
+static tTriggeredBomb bombChain[MAX_BOMB_POOL]; /* list of triggered bombs for the current tick */
 static uint8_t bombChainCount;       /* number of valid items in `bombChain` */
-static int8_t dx, dy, ds;            /* player movement (delta x, delta y, delta step; allowed values for dx/dy: -1, 0, 1) */
-static uint8_t x, y;                 /* player reference tile coordinates for collision detection */
-static uint8_t x1, y1;               /* helper variables for player collision detection */
-static uint8_t x2, y2;               /* helper variables for player collision detection */
-static uint8_t * field;              /* pointer to the upper left game field tile */
-static uint8_t * attrField;          /* pointer to the upper left game field tile attribute */
-static bool b;                       /* boolean used in bgSlideIn/bgSlideOut */
+static uint16_t dangerTick[CELL_COUNT]; /* earliest `counter10Hz` value at which an explosion reaches each cell (in the past if none) */
+static uint16_t dangerTime;          /* `dangerTick` value painted by `paintDanger()` */
+static uint8_t dangerQueue[MAX_BOMB_POOL]; /* stack of `bombPool` indices to paint into `dangerTick` */
+static uint8_t dangerQueueCount;     /* number of valid items in `dangerQueue` */
+static bool dangerQueued[MAX_BOMB_POOL]; /* `bombPool` index contained in `dangerQueue`? */
+static bool dangerRescan;            /* repaint all bombs (explosions changed the game field) */
+static uint8_t searchQueue[CELL_COUNT]; /* cells to expand by the running path search in breadth-first order */
+static uint8_t searchHead;           /* next `searchQueue` item to expand */
+static uint8_t searchTail;           /* number of valid items in `searchQueue` */
+static uint8_t searchFrom[CELL_COUNT]; /* predecessor of each visited cell on its shortest path */
+static uint8_t searchDepth[CELL_COUNT]; /* path length in cells of each visited cell */
+static uint8_t searchMark[CELL_COUNT]; /* cell visited if equal to `searchId` */
+static uint8_t searchId;             /* identifies the running path search (avoids clearing `searchMark`) */
+static uint8_t searchPlayer;         /* `players` index of the CPU player of the running path search */
+static uint8_t searchStart;          /* cell at which the running path search started */
+static uint8_t searchRange;          /* bomb range of `searchPlayer` */
+static uint8_t searchFoes[MAX_PLAYERS]; /* cells of the opponents of `searchPlayer` */
+static uint8_t searchFoeCount;       /* number of valid items in `searchFoes` */
+static uint8_t searchSafe;           /* nearest cell out of any explosion */
+static uint8_t searchEscape;         /* nearest safe cell out of reach of a bomb at `searchStart` */
+static uint8_t searchItem;           /* nearest safe power-up */
+static uint8_t searchTarget;         /* nearest safe cell to drop a bomb at next to a bricked wall or in reach of an opponent */
+static uint8_t searchLast;           /* most distant safe cell */
+/* `i`, `j`, `j2`, `k`, `m`, `dx`, `dy`, `ds`, `x`, `y`, `x1`, `y1`, `x2`, `y2` and `tiles` are defined in the direct page (see utility.h) */
+static bool b;                       /* generic boolean */
+/* `spriteTable`, `spriteHigh` and their changed ranges are defined in utility.asm */
+static uint8_t spriteFree[SPRITE_COUNT]; /* stack of unused sprites */
+static uint8_t spriteFreeCount;      /* number of valid items in `spriteFree` */
+static uint16_t p34Pal[32];          /* sprite palettes of player 3 and 4 (derived from `p12Pal`) */
 static uint8_t digits[5];            /* number conversion array */
-static uint8_t gameFieldLow[32*28];  /* in-memory game screen tile indices to decouple VRAM access (only low byte values) */
-static uint8_t gameFieldHigh[32*28]; /* in-memory game screen tile attributes to decouple VRAM access (only high byte values) */
-static uint8_t aniField[32*28];      /* animation frame index of each game field */
-static uint8_t ttlField[32*28];      /* animation frame time to live of each game field */
+/* `cellMap`, `cellGfx`, `aniCell`, `ttlCell`, `bombMap`, `aniList` and `dirtyCells` are defined in utility.asm */
+static uint8_t renderTiles[MAX_RENDER_CELLS][8]; /* rendered tile map words (two rows of two tiles) of the changed game fields */
+static uint16_t renderOffsets[MAX_RENDER_CELLS]; /* upper left tile offset for each `renderTiles` entry */
+static uint8_t renderCount;          /* number of valid items in `renderTiles` */
+static uint8_t streamRow;            /* next game field row below `MAP_FIELD_ROWS` to be streamed to VRAM by `renderCells()` */
+static uint8_t cameraY;              /* vertical camera offset of the game field in pixels (0 to `CAMERA_MAX`) */
+static uint8_t hudField[HUD_ROWS * HUD_COLS]; /* game screen tile indices of the two status rows above the game field */
+static uint8_t hudFirst[HUD_ROWS];   /* first changed `hudField` column of each row within the current frame */
+static uint8_t hudEnd[HUD_ROWS];     /* column after the last changed `hudField` column of each row (unchanged if not above `hudFirst`) */
 static uint8_t framesUntil10Hz;      /* remaining frames until next 10Hz tick */
+static uint16_t gameVBlank;          /* `snes_vblank_count` of the last game clock update (see `resetGameClock()`) */
+static uint16_t frameDelta;          /* frames elapsed since the last game clock update */
+static uint8_t clockFrames;          /* remaining frames to advance the game clock by (carried over to the next `handleGame()` call) */
+static bool tickPhase;               /* current game clock frame performs a tick phase? */
 static uint16_t counter10Hz;         /* 10Hz counter */
 static uint8_t untilSecond;          /* 10Hz ticks until next full second */
-static bool refreshGameScreenLow;    /* need low byte game screen low bytes refresh? */
-static bool refreshGameScreenHigh;   /* need low byte game screen high bytes refresh? */
 static bool refreshSprites;          /* need to update the sprite object attribute data? */
+static bool frameReady;              /* frame completed; queued VRAM updates may be performed by the VBlank handler */
+static int16_t slidePos;             /* current horizontal scroll position of the active slide */
+static int8_t slideSpeed;            /* scroll position change per frame of the active slide (negative for slide-out) */
+static uint8_t slideBg0;             /* first SNES background of the active slide */
+static uint8_t slideBg1;             /* second SNES background of the active slide or `INVALID_NR` */
+static bool slideSprites;            /* active slide moves the sprites as well? */
+static bool slideActive;             /* slide in progress within the VBlank handler? */
+static uint8_t optionsText[5][5];    /* option values as shown on the options screen (see `O_TIME` etc.) */
+#if defined(HAS_BGM) || defined(HAS_SFX)
+static uint8_t audioStage;           /* next audio boot stage or `AUDIO_READY` (see `bootAudioStep()`) */
+#endif /* HAS_BGM or HAS_SFX */
 #ifdef HAS_SFX
-static uint8_t sfx1Playing;          /* number of 1/10s remaining until the sound effect has completed */
-static brrsamples sfx1Sample[1];     /* sound effect sample */
+static brrsamples sfxSamples[SFX_COUNT]; /* sound table entries of the sound effects */
+static uint8_t sfxQueue[SFX_COUNT];  /* queued sound effect events in order (see `queueSfx()`) */
+static uint8_t sfxQueueCount;        /* number of valid entries in `sfxQueue` */
+static uint8_t sfxQueued;            /* bit mask of the sound effects within `sfxQueue` */
+static uint8_t sfxPlaying;           /* sound effect currently playing or `SFX_COUNT` */
+static uint8_t sfxRemaining;         /* number of 1/10s remaining until `sfxPlaying` has completed */
 #endif /* HAS_SFX */
+#ifdef USE_REPLAY
+static const tReplayEntry * replayEntry; /* next `replayData` entry */
+static uint16_t replayCount;         /* remaining main loop iterations with the current pad values */
+#endif /* USE_REPLAY */
+#ifdef BENCH
+static uint8_t benchIdx;             /* current benchmark scenario */
+static uint16_t benchFrame;          /* current frame within the benchmark scenario */
+static uint16_t benchCount;          /* `snes_vblank_count` at the start of the current frame */
+static uint16_t benchLine;           /* scanline at the start of the current frame */
+static uint16_t benchCost;           /* scanlines used by the current frame */
+static uint32_t benchSum;            /* sum of all frame costs of the current benchmark scenario */
+#endif /* BENCH */
+#ifdef REC_REPLAY
+static tReplayEntry replayBuffer[REPLAY_RECORD_SIZE]; /* recorded pad values in `replayData` format */
+static uint16_t replayRecordCount;   /* number of valid items in `replayBuffer` (without end marker) */
+#endif /* REC_REPLAY */
 /* configuration */
 static uint16_t maxTime;
 static uint8_t dropRate, dropRate255;
 static uint8_t maxBombs, maxRange;
+static uint8_t humanPlayers;         /* the remaining players of the match are CPU players */
+static tMatch matchStart;            /* game field of the last initialized match (see `restoreMatch()`) */
+static uint8_t idlePeak[ARRAY_SIZE(idleTasks)]; /* longest measured slice in scanlines of each `idleTasks` entry */
+static uint8_t idleIdx;              /* current `idleTasks` index */
+static bool idleMore;                /* current idle task has more work pending? */
+static uint16_t idleLine;            /* scanline at the start of the current idle task slice */
+static uint16_t idleEnd;             /* scanline at the end of the current idle task slice */
+static uint16_t idleFrame;           /* `snes_vblank_count` at the start of `runIdleTasks()` */
 
 
 /**
@@ -958,34 +1325,108 @@ static void convertNumber(uint16_t value) {
 
 
 /**
- * Writes a numeric value with unit and padded end using foreground 2 tiles.
+ * Marks the given `hudField` range as changed. The changed ranges are
+ * transferred with the next completed frame by `flushHud()`.
+ *
+ * @param[in] index - first `hudField` index
+ * @param[in] count - number of changed tiles
+ */
+static void updateHud(uint8_t index, uint8_t count) {
+	ASSERT((uint16_t)(index + count) <= sizeof(hudField));
+	while (count != 0) {
+		ASSERT_ARY_IDX(hudFirst, index / HUD_COLS);
+		if (hudFirst[index / HUD_COLS] >= hudEnd[index / HUD_COLS]) {
+			/* first change within this row */
+			hudFirst[index / HUD_COLS] = (uint8_t)(index % HUD_COLS);
+			hudEnd[index / HUD_COLS] = 0;
+		} else if ((index % HUD_COLS) < hudFirst[index / HUD_COLS]) {
+			hudFirst[index / HUD_COLS] = (uint8_t)(index % HUD_COLS);
+		}
+		if (count > (HUD_COLS - (index % HUD_COLS))) {
+			/* continues in the next row */
+			hudEnd[index / HUD_COLS] = HUD_COLS;
+			count = (uint8_t)(count - (HUD_COLS - (index % HUD_COLS)));
+			index = (uint8_t)((index | (HUD_COLS - 1)) + 1);
+		} else {
+			if (((index % HUD_COLS) + count) > hudEnd[index / HUD_COLS]) {
+				hudEnd[index / HUD_COLS] = (uint8_t)((index % HUD_COLS) + count);
+			}
+			count = 0;
+		}
+	}
+}
+
+
+/**
+ * Queues a single VRAM transfer for the changed range of the given
+ * `hudField` row.
+ *
+ * @param[in] row - `hudField` row (0 to `HUD_ROWS - 1`)
+ */
+static inline void flushHudRow(const uint8_t row) {
+	if (hudFirst[row] < hudEnd[row]) {
+		vramQueueAdd(hudField + (row * HUD_COLS) + hudFirst[row], WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + (row * HUD_COLS) + hudFirst[row], hudEnd[row] - hudFirst[row], VRAM_LOW);
+		hudFirst[row] = HUD_COLS;
+		hudEnd[row] = 0;
+	}
+}
+
+
+/**
+ * Queues the VRAM transfers of all `hudField` changes of the current frame,
+ * i.e. one transfer per changed row. Called by `WaitForVBlank()`.
+ */
+static void flushHud(void) {
+	flushHudRow(0);
+	flushHudRow(1);
+}
+
+
+/**
+ * Sets the tiles of a 16x16 icon in `hudField` without marking it as changed.
+ *
+ * @param[in] index - upper left `hudField` index
+ * @param[in] offset - tile index base offset
+ */
+static void setHudIcon(const uint16_t index, const uint8_t offset) {
+	ASSERT_ARY_IDX(hudField, index + 0x21);
+	hudField[index + 0x00] = (uint8_t)(offset + 0x00);
+	hudField[index + 0x01] = (uint8_t)(offset + 0x01);
+	hudField[index + 0x20] = (uint8_t)(offset + 0x10);
+	hudField[index + 0x21] = (uint8_t)(offset + 0x11);
+}
+
+
+/**
+ * Writes a numeric value with unit and padded end using foreground 2 tiles
+ * to `hudField` and marks it as changed.
  *
- * @param[in] index - `gameFieldLow` index
+ * @param[in] index - `hudField` index
  * @param[in] chars - number of characters to write (padded with spaces at the end)
  * @param[in] value - numeric value to write
  * @param[in] unit - number unit (single character)
- * @remarks Should be called during V-blank to avoid glitches.
  */
 static void writeNumWithUnit(uint16_t index, uint8_t chars, uint16_t value, const uint8_t unit) {
+	updateHud(index, chars);
 	convertNumber(value);
 	/* write digits */
 	while (chars != 0 && i != 0) {
 		--i;
 		ASSERT_ARY_IDX(digits, i);
-		ASSERT_ARY_IDX(gameFieldLow, index);
-		gameFieldLow[index++] = digits[i];
+		ASSERT_ARY_IDX(hudField, index);
+		hudField[index++] = digits[i];
 		--chars;
 	}
 	/* write unit */
 	if (chars != 0) {
-		ASSERT_ARY_IDX(gameFieldLow, index);
-		gameFieldLow[index++] = unit;
+		ASSERT_ARY_IDX(hudField, index);
+		hudField[index++] = unit;
 		--chars;
 	}
 	/* pad remaining with spaces */
 	while (chars != 0) {
-		ASSERT_ARY_IDX(gameFieldLow, index);
-		gameFieldLow[index++] = CH_space;
+		ASSERT_ARY_IDX(hudField, index);
+		hudField[index++] = CH_space;
 		--chars;
 	}
 }
@@ -995,153 +1436,374 @@ static void writeNumWithUnit(uint16_t index, uint8_t chars, uint16_t value, cons
  * Writes a numeric value with unit and padded end using foreground 2 tiles.
  *
  * @param[in] address - VRAM address (word offset)
+ * @param[out] text - buffer for the written characters (at least `chars` in size)
  * @param[in] chars - number of characters to write (padded with spaces at the end)
  * @param[in] value - numeric value to write
  * @param[in] unit - number unit (single character)
  * @param[in] select - selection mark (single character)
- * @remarks Should be called during V-blank to avoid glitches.
+ * @remarks The VRAM transfer is being queued and `text` needs to remain valid until the next VBlank.
  */
-static void writeVramNumWithUnit(const uint16_t address, uint8_t chars, uint16_t value, const uint8_t unit, const uint8_t select) {
+static void writeVramNumWithUnit(const uint16_t address, uint8_t * text, uint8_t chars, uint16_t value, const uint8_t unit, const uint8_t select) {
 	convertNumber(value);
-	/* ensure access to VRAM */
-	WaitForVBlank();
-	/* increment VRAM address after each low byte write (REG_VMDATAL) */
-	REG_VMAIN = 0x00;
-	REG_VMADDLH = address;
+	/* queue the transfer (`text` is read with the next VBlank) */
+	vramQueueAdd(text, address, chars, VRAM_LOW);
 	/* write digits */
 	while (chars != 0 && i != 0) {
 		--i;
 		ASSERT_ARY_IDX(digits, i);
-		REG_VMDATAL = digits[i];
+		*text++ = digits[i];
 		--chars;
 	}
 	/* write unit */
 	if (chars != 0) {
-		REG_VMDATAL = unit;
+		*text++ = unit;
 		--chars;
 	}
 	/* write selection mark */
 	if (chars != 0) {
-		REG_VMDATAL = select;
+		*text++ = select;
 		--chars;
 	}
 	/* pad remaining with spaces */
 	while (chars != 0) {
-		REG_VMDATAL = CH_space;
+		*text++ = CH_space;
 		--chars;
 	}
 }
 
 
-#ifdef HAS_SFX
+#if defined(HAS_BGM) || defined(HAS_SFX)
 /**
- * Play bomb sound effect.
+ * Performs the next audio boot stage. The single stages still block
+ * until their upload to the SPC700 completed but are spread over
+ * consecutive frames of the title screen. The NMI driven slides, VRAM
+ * updates and pad sampling continue in the meantime.
+ *
+ * @remarks Shall be called at most once per frame before `WaitForVBlank()`.
  */
-static inline void playSfx1() {
-	if ( sfx1Playing ) {
+static void bootAudioStep(void) {
+	switch (audioStage) {
+	case AUDIO_BOOT:
+		/* initialize sound engine (slow) */
+		spcBoot();
+		break;
+	case AUDIO_BANKS:
+#ifdef HAS_BGM
+		/* set soundbank available in bgm1.asm in reverse order */
+		spcSetBank(&SOUNDBANK__1);
+		spcSetBank(&SOUNDBANK__0);
+#endif /* HAS_BGM */
+		break;
+	case AUDIO_SFX:
+#ifdef HAS_SFX
+		/* allocate sound ram for the largest sound effect (see `bin/sfx.h`) */
+		spcAllocateSoundRegion(SFX_REGION_SIZE);
+		/* load sound effects in the order of `SFX_EXPLOSION` etc. */
+		for (i = 0; i < SFX_COUNT; ++i) {
+			spcSetSoundEntry(15, 7, 5, (uint16_t)(sfxInfo[i].end - sfxInfo[i].data), sfxInfo[i].data, sfxSamples + i);
+		}
+#endif /* HAS_SFX */
+		break;
+	case AUDIO_BGM:
+#ifdef HAS_BGM
+		/* load the background music using the ID defined in `bgm1.h` */
+		spcLoad(MOD_BGM1);
+#endif /* HAS_BGM */
+		break;
+	case AUDIO_PLAY:
+#ifdef HAS_BGM
+		/* start BGM with little volume (the game may already be paused at this point) */
+		spcSetModuleVolume((screen == S_PAUSE) ? BGM_PAUSE_VOL : BGM_NORMAL_VOL);
+		spcPlay(0);
+#endif /* HAS_BGM */
+		break;
+	default:
 		return;
 	}
-	spcPlaySound(0);
-	sfx1Playing = 6; /* x 100ms */
+	++audioStage;
 }
-#endif /* HAS_SFX */
+#endif /* HAS_BGM or HAS_SFX */
 
 
+#ifdef HAS_SFX
 /**
- * Sets the X offset for all sprites.
+ * Queues the given sound effect event for `updateSfx()`. Events of
+ * the same sound effect are merged until the next frame, e.g. for
+ * chain explosions.
  *
- * @param[in] offset - new x offset
+ * @param[in] id - sound effect (see `SFX_EXPLOSION` etc.)
  */
-static inline void setSpritesOffsetX(const uint16_t offset) {
-	oamSetXY(P1_NR, p1.x + offset + 8, p1.y);
-	oamSetXY(P2_NR, p2.x + offset + 8, p2.y);
-}
+#define queueSfx(id) \
+	if ( ! (sfxQueued & (1 << (id))) ) { \
+		ASSERT_ARY_IDX(sfxQueue, sfxQueueCount); \
+		sfxQueued |= (uint8_t)(1 << (id)); \
+		sfxQueue[sfxQueueCount++] = (id); \
+	}
 
 
 /**
- * Perform a slide-in of the given SNES background.
- * Set bgNum1 to INVALID_NR to slide only one SNES background.
+ * Starts the queued sound effect with the highest priority. The
+ * playing sound effect is restarted or interrupted by one with the
+ * same or a higher priority, e.g. for each step of a chain explosion
+ * spread over several ticks. All other queued events are dropped.
+ * Queued events are dropped until the audio boot completed as well.
  *
- * @param[in] bgNum0 - foreground number (0 to 3)
- * @param[in] bgNum1 - background number (0 to 3)
- * @param[in] sprites - slide-in sprites as well?
+ * @remarks Shall be called at most once per frame before `WaitForVBlank()`.
+ * @remarks Uses `j` and `j2` internally.
  */
-static void bgSlideIn(const uint8_t bgNum0, const uint8_t bgNum1, const bool sprites) {
-	WaitForVBlank();
-	for (k = 0, b = false; !b; k += SLIDE_SPEED) {
-		if (k >= 256) {
-			bgSetScroll(bgNum0, 256, VERT_OFFSET);
-			if (bgNum1 != INVALID_NR) {
-				bgSetScroll(bgNum1, 256, VERT_OFFSET);
-			}
-			if ( sprites ) {
-				setSpritesOffsetX(0);
-			}
-			b = true;
-		} else {
-			bgSetScroll(bgNum0, k, VERT_OFFSET);
-			if (bgNum1 != INVALID_NR) {
-				bgSetScroll(bgNum1, k, VERT_OFFSET);
-			}
-			if ( sprites ) {
-				setSpritesOffsetX(256 - k);
+static void updateSfx(void) {
+	if ( sfxQueueCount == 0 ) {
+		return;
+	}
+	if ( audioStage == AUDIO_READY ) {
+		/* select the event with the highest priority (first one on equal priority) */
+		j = sfxQueue[0];
+		for (j2 = 1; j2 < sfxQueueCount; ++j2) {
+			if (sfxInfo[sfxQueue[j2]].priority > sfxInfo[j].priority) {
+				j = sfxQueue[j2];
 			}
 		}
-		if ( sprites ) {
-			/* avoid delay by one frame */
-			oamUpdate();
+		/* restart the voice or steal it from a lower priority sound effect */
+		if (sfxRemaining == 0 || sfxInfo[j].priority >= sfxInfo[sfxPlaying].priority) {
+			spcPlaySound(j);
+			sfxPlaying = j;
+			sfxRemaining = sfxInfo[j].ticks;
 		}
-		WaitForVBlank();
 	}
+	sfxQueueCount = 0;
+	sfxQueued = 0;
 }
+#endif /* HAS_SFX */
+
+
+/** Bit mask of the x bit 8 of a sprite within its `spriteHigh` byte. */
+static const uint8_t spriteHighX[4] = {0x01, 0x04, 0x10, 0x40};
 
 
 /**
- * Perform a slide-out of the given SNES background.
- * Set bgNum1 to INVALID_NR to slide only one SNES background.
+ * Marks the given sprite as changed in `spriteTable`.
  *
- * @param[in] bgNum0 - background number (0 to 3)
- * @param[in] bgNum1 - background number (0 to 3)
- * @param[in] sprites - slide-in sprites as well?
+ * @param[in] id - sprite (0 to `SPRITE_COUNT - 1`)
  */
-static void bgSlideOut(const uint8_t bgNum0, const uint8_t bgNum1, const bool sprites) {
-	WaitForVBlank();
-	for (k = 256, b = false; !b; k -= SLIDE_SPEED) {
-		if (k > 256) {
-			bgSetScroll(bgNum0, 0, VERT_OFFSET);
-			if (bgNum1 != INVALID_NR) {
-				bgSetScroll(bgNum1, 0, VERT_OFFSET);
-			}
-			if ( sprites ) {
-				setSpritesOffsetX(256);
-			}
-			b = true;
-		} else {
-			bgSetScroll(bgNum0, k, VERT_OFFSET);
-			if (bgNum1 != INVALID_NR) {
-				bgSetScroll(bgNum1, k, VERT_OFFSET);
-			}
-			if ( sprites ) {
-				setSpritesOffsetX(256 - k);
-			}
-		}
-		if ( sprites ) {
-			/* avoid delay by one frame */
-			oamUpdate();
+static inline void markSpriteDirty(const uint8_t id) {
+	if (spriteFirst >= spriteEnd) {
+		spriteFirst = id;
+		spriteEnd = (uint8_t)(id + 1);
+	} else if (id < spriteFirst) {
+		spriteFirst = id;
+	} else if (id >= spriteEnd) {
+		spriteEnd = (uint8_t)(id + 1);
+	}
+}
+
+
+/**
+ * Marks the `spriteHigh` byte of the given sprite as changed.
+ *
+ * @param[in] id - sprite (0 to `SPRITE_COUNT - 1`)
+ */
+static inline void markSpriteHighDirty(const uint8_t id) {
+	if (spriteHighFirst >= spriteHighEnd) {
+		spriteHighFirst = (uint8_t)(id / 4);
+		spriteHighEnd = (uint8_t)((id / 4) + 1);
+	} else if ((id / 4) < spriteHighFirst) {
+		spriteHighFirst = (uint8_t)(id / 4);
+	} else if ((id / 4) >= spriteHighEnd) {
+		spriteHighEnd = (uint8_t)((id / 4) + 1);
+	}
+}
+
+
+/**
+ * Hides all sprites, sets them to the small size and marks them as unused.
+ * The whole object attribute memory is being transferred with the next VBlank.
+ */
+static void initSprites(void) {
+	for (i = 0; i < SPRITE_COUNT; ++i) {
+		ASSERT_ARY_IDX(spriteFree, i);
+		spriteTable[(i * 4) + 0] = 0;
+		spriteTable[(i * 4) + 1] = SPRITE_HIDE_Y;
+		spriteTable[(i * 4) + 2] = 0;
+		spriteTable[(i * 4) + 3] = 0;
+		spriteFree[i] = (uint8_t)(SPRITE_COUNT - 1 - i);
+	}
+	memset(spriteHigh, 0, sizeof(spriteHigh));
+	spriteFreeCount = SPRITE_COUNT;
+	spriteFirst = 0;
+	spriteEnd = SPRITE_COUNT;
+	spriteHighFirst = 0;
+	spriteHighEnd = sizeof(spriteHigh);
+}
+
+
+/**
+ * Takes an unused sprite. The sprite remains hidden until it is being set.
+ *
+ * @return sprite (0 to `SPRITE_COUNT - 1`)
+ */
+static inline uint8_t allocSprite(void) {
+	ASSERT(spriteFreeCount != 0);
+	--spriteFreeCount;
+	return spriteFree[spriteFreeCount];
+}
+
+
+/**
+ * Sets the position of the given sprite.
+ *
+ * @param[in] id - sprite (0 to `SPRITE_COUNT - 1`)
+ * @param[in] x - x coordinate (0 to 511; 256 and above are off-screen to the right)
+ * @param[in] y - y coordinate
+ */
+static void setSpriteXY(const uint8_t id, const uint16_t x, const uint8_t y) {
+	ASSERT(id < SPRITE_COUNT);
+	spriteTable[(id * 4) + 0] = (uint8_t)x;
+	spriteTable[(id * 4) + 1] = y;
+	markSpriteDirty(id);
+	if (((spriteHigh[id / 4] & spriteHighX[id % 4]) != 0) != ((x & 0x100) != 0)) {
+		/* x bit 8 changed */
+		spriteHigh[id / 4] ^= spriteHighX[id % 4];
+		markSpriteHighDirty(id);
+	}
+}
+
+
+/**
+ * Sets the position and graphic of the given sprite.
+ *
+ * @param[in] id - sprite (0 to `SPRITE_COUNT - 1`)
+ * @param[in] x - x coordinate (0 to 511; 256 and above are off-screen to the right)
+ * @param[in] y - y coordinate
+ * @param[in] tile - sprite tile number
+ * @param[in] attr - sprite attributes (see `SPRITE_ATTR()`)
+ */
+static void setSprite(const uint8_t id, const uint16_t x, const uint8_t y, const uint8_t tile, const uint8_t attr) {
+	ASSERT(id < SPRITE_COUNT);
+	spriteTable[(id * 4) + 2] = tile;
+	spriteTable[(id * 4) + 3] = attr;
+	setSpriteXY(id, x, y);
+}
+
+
+/**
+ * Hides the given sprite until its position is being set again.
+ *
+ * @param[in] id - sprite (0 to `SPRITE_COUNT - 1`)
+ */
+static inline void hideSprite(const uint8_t id) {
+	ASSERT(id < SPRITE_COUNT);
+	spriteTable[(id * 4) + 1] = SPRITE_HIDE_Y;
+	markSpriteDirty(id);
+}
+
+
+/**
+ * Sets the X offset for the sprites of all players in the match.
+ *
+ * @param[in] offset - new x offset
+ * @remarks Uses `offsetIdx` internally.
+ */
+static void setSpritesOffsetX(const uint16_t offset) {
+	for (offsetIdx = 0; offsetIdx < playerCount; ++offsetIdx) {
+		if (players[offsetIdx].bit & alivePlayers) {
+			setSpriteXY(players[offsetIdx].sprite, players[offsetIdx].x + offset + 8, (uint8_t)(players[offsetIdx].y - cameraY));
 		}
+	}
+}
+
+
+/**
+ * Advances the active slide-in or slide-out by one step. Called by the
+ * VBlank handler to keep the slide independent from the main loop.
+ *
+ * @remarks Uses `slidePos`, `slideSpeed`, `slideBg0`, `slideBg1`, `slideSprites` and `slideActive`.
+ */
+static inline void slideStep(void) {
+	if ( ! slideActive ) {
+		return;
+	}
+	if (slideSpeed > 0 ? slidePos >= 256 : slidePos < 0) {
+		/* final position reached */
+		slidePos = (slideSpeed > 0) ? 256 : 0;
+		slideActive = false;
+	}
+	bgSetScroll(slideBg0, slidePos, VERT_OFFSET);
+	if (slideBg1 != INVALID_NR) {
+		bgSetScroll(slideBg1, slidePos, VERT_OFFSET);
+	}
+	if ( slideSprites ) {
+		/* the changed sprites get transferred by `spriteFlush()` right after this */
+		setSpritesOffsetX(256 - slidePos);
+	}
+	slidePos += slideSpeed;
+}
+
+
+/**
+ * Wait until the current slide-in or slide-out has completed.
+ */
+static void bgSlideWait(void) {
+	while ( slideActive ) {
 		WaitForVBlank();
 	}
 }
 
 
+/**
+ * Start a slide-in of the given SNES background.
+ * Set bgNum1 to INVALID_NR to slide only one SNES background.
+ * The slide is performed by the VBlank handler. Use `bgSlideWait()`
+ * to wait for its completion.
+ *
+ * @param[in] bgNum0 - foreground number (0 to 3)
+ * @param[in] bgNum1 - background number (0 to 3)
+ * @param[in] sprites - slide-in sprites as well?
+ */
+static void bgSlideIn(const uint8_t bgNum0, const uint8_t bgNum1, const bool sprites) {
+	bgSlideWait();
+	/* commit the pending updates of the hidden page first */
+	WaitForVBlank();
+	slidePos = 0;
+	slideSpeed = SLIDE_SPEED;
+	slideBg0 = bgNum0;
+	slideBg1 = bgNum1;
+	slideSprites = sprites;
+	slideActive = true;
+}
+
+
+/**
+ * Start a slide-out of the given SNES background.
+ * Set bgNum1 to INVALID_NR to slide only one SNES background.
+ * The slide is performed by the VBlank handler. Use `bgSlideWait()`
+ * to wait for its completion. VRAM updates queued in the meantime are
+ * deferred until it has completed.
+ *
+ * @param[in] bgNum0 - background number (0 to 3)
+ * @param[in] bgNum1 - background number (0 to 3)
+ * @param[in] sprites - slide-out sprites as well?
+ */
+static void bgSlideOut(const uint8_t bgNum0, const uint8_t bgNum1, const bool sprites) {
+	bgSlideWait();
+	WaitForVBlank();
+	slidePos = 256;
+	slideSpeed = -SLIDE_SPEED;
+	slideBg0 = bgNum0;
+	slideBg1 = bgNum1;
+	slideSprites = sprites;
+	slideActive = true;
+}
+
+
 /**
  * Updates the shown configuration values on the options screen.
  */
 static void updateOptionsScreen(void) {
-	writeVramNumWithUnit(WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(10, 11), 5, maxTime,  CH_s,       (option == O_TIME)     ? CH_less : CH_space);
-	writeVramNumWithUnit(WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(10, 14), 5, dropRate, CH_percent, (option == O_DROPRATE) ? CH_less : CH_space);
-	writeVramNumWithUnit(WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(10, 17), 3, maxBombs, CH_x,       (option == O_BOMBS)    ? CH_less : CH_space);
-	writeVramNumWithUnit(WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(10, 20), 3, maxRange, CH_x,       (option == O_RANGE)    ? CH_less : CH_space);
+	writeVramNumWithUnit(WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(10, 11), optionsText[O_TIME],     5, maxTime,  CH_s,       (option == O_TIME)     ? CH_less : CH_space);
+	writeVramNumWithUnit(WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(10, 14), optionsText[O_DROPRATE], 5, dropRate, CH_percent, (option == O_DROPRATE) ? CH_less : CH_space);
+	writeVramNumWithUnit(WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(10, 17), optionsText[O_BOMBS],    3, maxBombs, CH_x,       (option == O_BOMBS)    ? CH_less : CH_space);
+	writeVramNumWithUnit(WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(10, 20), optionsText[O_RANGE],    3, maxRange, CH_x,       (option == O_RANGE)    ? CH_less : CH_space);
+	writeVramNumWithUnit(WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(10, 23), optionsText[O_HUMANS],   3, humanPlayers, CH_P,   (option == O_HUMANS)   ? CH_less : CH_space);
 }
 
 
@@ -1151,125 +1813,911 @@ static void updateOptionsScreen(void) {
  * @param[in] stopIcon - false for clock, true for stop icon
  */
 static void changeClockIcon(const bool stopIcon) {
-	/* increment VRAM address after each low byte write (REG_VMDATAL) */
-	REG_VMAIN = 0x00;
-	REG_VMADDLH = WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(13, 0);
 	if ( stopIcon ) {
-		REG_VMDATAL = FIELD_PAUSE + 0x00;
-		REG_VMDATAL = FIELD_PAUSE + 0x01;
-		REG_VMADDLH = WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(13, 1);
-		REG_VMDATAL = FIELD_PAUSE + 0x10;
-		REG_VMDATAL = FIELD_PAUSE + 0x11;
+		setHudIcon(TILE_OFFSET(13, 0), FIELD_PAUSE);
 	} else {
-		REG_VMDATAL = FIELD_TIME + 0x00;
-		REG_VMDATAL = FIELD_TIME + 0x01;
-		REG_VMADDLH = WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE) + TILE_OFFSET(13, 1);
-		REG_VMDATAL = FIELD_TIME + 0x10;
-		REG_VMDATAL = FIELD_TIME + 0x11;
+		setHudIcon(TILE_OFFSET(13, 0), FIELD_TIME);
 	}
+	updateHud(TILE_OFFSET(13, 0), 2);
+	updateHud(TILE_OFFSET(13, 1), 2);
 }
 
 
 /**
- * Updates the player sprites object attributes from `p1` and `p2`.
+ * Updates the sprites of all players in the match. Each player uses its own
+ * sprite palette (4 to 7).
+ *
+ * @remarks Uses `playerIdx` and `curPlayer` internally.
  */
 static void updatePlayerSprites(void) {
-	ASSERT_ARY_IDX(playerTileMap, p1.curFrame);
-	ASSERT_ARY_IDX(playerTileMap, p2.curFrame);
-	oamSet(P1_NR, p1.x + 8, p1.y, 3, p1.flipX, 0, playerTileMap[p1.curFrame], 4);
-	oamSet(P2_NR, p2.x + 8, p2.y, 3, p2.flipX, 0, playerTileMap[p2.curFrame], 5);
+	for (playerIdx = 0; playerIdx < playerCount; ++playerIdx) {
+		curPlayer = players + playerIdx;
+		if (curPlayer->bit & alivePlayers) {
+			ASSERT_ARY_IDX(playerTileMap, curPlayer->curFrame);
+			setSprite(curPlayer->sprite, curPlayer->x + 8, (uint8_t)(curPlayer->y - cameraY), playerTileMap[curPlayer->curFrame], SPRITE_ATTR(4 + playerIdx, 3, curPlayer->flipX));
+		}
+	}
 	refreshSprites = false;
 }
 
 
+/**
+ * Hides the sprites of all players.
+ *
+ * @remarks Uses `playerIdx` internally.
+ */
+static void hidePlayerSprites(void) {
+	for (playerIdx = 0; playerIdx < MAX_PLAYERS; ++playerIdx) {
+		hideSprite(players[playerIdx].sprite);
+	}
+}
+
+
+/**
+ * Moves the camera towards the offset which centers the uppermost and the
+ * lowermost remaining player in the scrolled screen lines. The camera jumps
+ * further if needed to keep the lowermost player on screen and, with
+ * precedence, the uppermost player below the status rows. No sprite of a
+ * remaining player hence overlaps the status rows.
+ *
+ * @param[in] snap - jump to the target offset instead of moving one pixel
+ * @remarks Uses `playerIdx`, `x1`, `x2`, `y1` and `y2` internally.
+ */
+static void updateCamera(const bool snap) {
+	y1 = 255;
+	y2 = 0;
+	for (playerIdx = 0; playerIdx < playerCount; ++playerIdx) {
+		if (players[playerIdx].bit & alivePlayers) {
+			if (players[playerIdx].y < y1) {
+				y1 = players[playerIdx].y;
+			}
+			if (players[playerIdx].y > y2) {
+				y2 = players[playerIdx].y;
+			}
+		}
+	}
+	if (y1 > y2) {
+		return; /* no remaining players */
+	}
+	/* target offset */
+	x1 = (uint8_t)(((uint16_t)y1 + y2) >> 1);
+	x1 = (uint8_t)((x1 > CAMERA_MID) ? (x1 - CAMERA_MID) : 0);
+	if (x1 > CAMERA_MAX) {
+		x1 = CAMERA_MAX;
+	}
+	x2 = cameraY;
+	if ( snap ) {
+		cameraY = x1;
+	} else if (cameraY < x1) {
+		++cameraY;
+	} else if (cameraY > x1) {
+		--cameraY;
+	}
+	/* players moving faster than the camera */
+	if (y2 > (uint8_t)(cameraY + CAMERA_BOTTOM)) {
+		cameraY = (uint8_t)(y2 - CAMERA_BOTTOM);
+	}
+	if ((uint8_t)(cameraY + CAMERA_TOP) > y1) {
+		cameraY = (uint8_t)(y1 - CAMERA_TOP);
+	}
+	if (cameraY != x2) {
+		/* the player sprites follow the camera */
+		refreshSprites = true;
+	}
+}
+
+
+/**
+ * Adds the given `bombPool` entry to the `bombWheel` slot of the given tick.
+ *
+ * @param[in] idx - `bombPool` index
+ * @param[in] tick - `counter10Hz` value of the next event of that bomb
+ * @remarks Uses `bomb` internally.
+ */
+static void linkBomb(const uint8_t idx, const uint16_t tick) {
+	ASSERT_ARY_IDX(bombPool, idx);
+	bomb = bombPool + idx;
+	bomb->slot = (uint8_t)(tick & (BOMB_WHEEL_SIZE - 1));
+	bomb->prev = INVALID_BOMB;
+	bomb->next = bombWheel[bomb->slot];
+	if (bomb->next != INVALID_BOMB) {
+		ASSERT_ARY_IDX(bombPool, bomb->next);
+		bombPool[bomb->next].prev = idx;
+	}
+	bombWheel[bomb->slot] = idx;
+}
+
+
+/**
+ * Removes the given `bombPool` entry from its `bombWheel` slot.
+ *
+ * @param[in] idx - `bombPool` index
+ * @remarks Uses `bomb` internally.
+ */
+static void unlinkBomb(const uint8_t idx) {
+	ASSERT_ARY_IDX(bombPool, idx);
+	bomb = bombPool + idx;
+	if (bomb->next != INVALID_BOMB) {
+		ASSERT_ARY_IDX(bombPool, bomb->next);
+		bombPool[bomb->next].prev = bomb->prev;
+	}
+	if (bomb->prev != INVALID_BOMB) {
+		ASSERT_ARY_IDX(bombPool, bomb->prev);
+		bombPool[bomb->prev].next = bomb->next;
+	} else {
+		/* first entry of its slot */
+		ASSERT_ARY_IDX(bombWheel, bomb->slot);
+		ASSERT(bombWheel[bomb->slot] == idx);
+		bombWheel[bomb->slot] = bomb->next;
+	}
+}
+
+
+/**
+ * Triggers the explosion of the given `bombPool` entry within the current
+ * tick. The bomb is removed from `bombMap` and added to `bombChain`.
+ * The caller needs to ensure that it is no longer linked in `bombWheel`.
+ *
+ * @param[in] idx - `bombPool` index
+ * @remarks Uses `bomb` internally.
+ */
+static void triggerBomb(const uint8_t idx) {
+	ASSERT_ARY_IDX(bombPool, idx);
+	ASSERT_ARY_IDX(bombChain, bombChainCount);
+	bomb = bombPool + idx;
+	ASSERT_ARY_IDX(bombMap, bomb->cell);
+	bombMap[bomb->cell] = INVALID_BOMB;
+	bombChain[bombChainCount].range = bomb->owner->range;
+	bombChain[bombChainCount].idx = idx;
+	++bombChainCount;
+}
+
+
+/**
+ * Returns the given `bombPool` entry to the list of unused entries and the
+ * bomb to its owner.
+ *
+ * @param[in] idx - `bombPool` index
+ * @remarks Uses `bomb` internally.
+ */
+static void freeBomb(const uint8_t idx) {
+	ASSERT_ARY_IDX(bombPool, idx);
+	ASSERT_ARY_IDX(bombFree, bombFreeCount);
+	bomb = bombPool + idx;
+	if (bomb->owner->lastBombIdx == idx) {
+		bomb->owner->lastBombIdx = INVALID_BOMB;
+	}
+	++bomb->owner->bombs;
+	ASSERT(bomb->owner->bombs <= bomb->owner->maxBombs);
+	bomb->owner = NULL;
+	bombFree[bombFreeCount] = idx;
+	++bombFreeCount;
+}
+
+
+/**
+ * Seeds the random number generator for the next round and discards the
+ * pooled values of the previous seed. Called when the options screen is
+ * entered so that `WaitForVBlank()` refills `lrngPool` before
+ * `initializeGame()` needs it.
+ */
+static void seedRandom(void) {
+#if defined(USE_REPLAY) || defined(REC_REPLAY)
+	lrngSeed = REPLAY_SEED; /* reproducible walls and power-ups */
+#else /* not USE_REPLAY and not REC_REPLAY */
+	*((uint16_t *)(&lrngSeed)) = snes_vblank_count | 0x40; /* initialize seed; ensure != zero */
+#endif /* not USE_REPLAY and not REC_REPLAY */
+	lrngPoolCount = 0;
+}
+
+
+/**
+ * Restarts the game clock with the current frame. Called whenever the game
+ * screen is being entered or resumed so that the frames spent elsewhere are
+ * not taken as lag frames.
+ */
+#define resetGameClock() \
+	gameVBlank = snes_vblank_count; \
+	clockFrames = 0
+
+
+#ifndef NDEBUG
+/**
+ * Shows the number of lag frames (see `frameStats`) in the upper status row.
+ *
+ * @remarks Uses `i` internally.
+ */
+#define showLagFrames() \
+	writeNumWithUnit(TILE_OFFSET(17, 0), 4, (frameStats.lagFrames < 1000) ? frameStats.lagFrames : 999, CH_x)
+#endif /* not NDEBUG */
+
+
+/**
+ * Resets the players, bombs, CPU players, timers and the camera for the game
+ * field currently set up.
+ *
+ * @remarks Uses `i`, `k`, `x1`, `x2`, `y1`, `y2`, `playerIdx` and `curPlayer` internally.
+ */
+static void resetMatch(void) {
+	dmaFillWram(fTypeCell + FTYPE_EMPTY, aniCell, sizeof(aniCell)); /* zero */
+	aniListCount = 0;
+	renderCount = 0;
+	/* initialize related variables */
+	alivePlayers = 0;
+	hitPlayers = 0;
+	for (playerIdx = 0; playerIdx < playerCount; ++playerIdx) {
+		curPlayer = players + playerIdx;
+		curPlayer->bombs = 1;
+		curPlayer->maxBombs = 1;
+		curPlayer->range = 1;
+		curPlayer->running = 0;
+		curPlayer->firstFrame = ACT_DOWN;
+		curPlayer->maxFrame = 3;
+		curPlayer->curFrame = ACT_DOWN;
+		curPlayer->flipX = 0;
+		curPlayer->moveAniIdx = 5;
+		curPlayer->moving = 0;
+		curPlayer->x = playerStartX[playerIdx];
+		curPlayer->y = playerStartY[playerIdx];
+		curPlayer->lastBombIdx = INVALID_BOMB;
+		alivePlayers |= curPlayer->bit;
+	}
+	/* CPU players without danger and decisions (see `humanPlayers`) */
+	cpuPlayers = (uint8_t)(((1 << playerCount) - 1) & ~((1 << humanPlayers) - 1));
+	for (i = 0; i < MAX_PLAYERS; ++i) {
+		cpus[i].pathLen = 0;
+		cpus[i].bombCell = INVALID_CELL;
+	}
+	for (k = 0; k < CELL_COUNT; ++k) {
+		dangerTick[k] = counter10Hz - 1;
+	}
+	memset(dangerQueued, 0, sizeof(dangerQueued));
+	dangerQueueCount = 0;
+	dangerRescan = false;
+	searchHead = searchTail = 0;
+	searchPlayer = MAX_PLAYERS - 1;
+	/* reset bomb pool */
+	for (i = 0; i < MAX_BOMB_POOL; ++i) {
+		ASSERT_ARY_IDX(bombPool, i);
+		bombPool[i].owner = NULL;
+		bombFree[i] = i;
+	}
+	bombFreeCount = MAX_BOMB_POOL;
+	memset(bombMap, INVALID_BOMB, sizeof(bombMap));
+	for (i = 0; i < BOMB_WHEEL_SIZE; ++i) {
+		bombWheel[i] = INVALID_BOMB;
+	}
+	dropRate255 = (uint8_t)((((uint16_t)dropRate) * 255) / 100);
+	framesUntil10Hz = FP10HZ;
+	untilSecond = 10;
+	gameOver = maxTime;
+	winner = WINNER_NA;
+	resetGameClock();
+	/* update remaining time on screen */
+	writeNumWithUnit(TILE_OFFSET(15, 1), 4, gameOver, CH_s);
+#ifndef NDEBUG
+	showLagFrames();
+#endif /* not NDEBUG */
+	/* update and show player sprites */
+	updateCamera(true);
+	updatePlayerSprites();
+	/* the game screen is not yet visible */
+	setSpritesOffsetX(256);
+	hidePlayerSprites();
+}
+
+
+/**
+ * Takes a snapshot of the game field initialized by `initializeGame()`
+ * for `restoreMatch()`.
+ */
+static void saveMatch(void) {
+	copyWram(cellMap, matchStart.cellMap, CELL_COUNT);
+	copyWram(cellGfx, matchStart.cellGfx, CELL_COUNT);
+	copyWram(rayLeft, matchStart.rayLeft, CELL_COUNT);
+	copyWram(rayRight, matchStart.rayRight, CELL_COUNT);
+	copyWram(rayUp, matchStart.rayUp, CELL_COUNT);
+	copyWram(rayDown, matchStart.rayDown, CELL_COUNT);
+	copyWram(hudField, matchStart.hudField, sizeof(hudField));
+	/* the changed fields get marked again on restore */
+	for (i = 0; i < ARRAY_SIZE(fieldElemIndex); ++i) {
+		matchStart.cellMap[fieldElemIndex[i]] &= (uint8_t)(~CELL_DIRTY);
+	}
+}
+
+
+/**
+ * Restores the game field of the last match from the snapshot of
+ * `saveMatch()` and resets the match state. All changeable game fields
+ * are queued for rendering as the game screen still shows the end of
+ * the last match.
+ *
+ * @remarks Uses `i`, `j`, `k`, `playerIdx` and `curPlayer` internally.
+ */
+static void restoreMatch(void) {
+	copyWram(matchStart.cellMap, cellMap, CELL_COUNT);
+	copyWram(matchStart.cellGfx, cellGfx, CELL_COUNT);
+	copyWram(matchStart.rayLeft, rayLeft, CELL_COUNT);
+	copyWram(matchStart.rayRight, rayRight, CELL_COUNT);
+	copyWram(matchStart.rayUp, rayUp, CELL_COUNT);
+	copyWram(matchStart.rayDown, rayDown, CELL_COUNT);
+	copyWram(matchStart.hudField, hudField, sizeof(hudField));
+	dirtyCellCount = 0;
+	for (i = 0; i < ARRAY_SIZE(fieldElemIndex); ++i) {
+		j = fieldElemIndex[i];
+		markCellDirty(j);
+	}
+	resetMatch();
+}
+
+
 /**
  * Initializes the in-memory game field data.
+ *
+ * @remarks Uses `i`, `j`, `k`, `playerIdx` and `curPlayer` internally.
  */
 static void initializeGame(void) {
-	/* copy tile indices of tile map from ROM */
-	for (k = 0, m = 0; m < ARRAY_SIZE(gameFieldLow); k += 2, ++m) {
-		ASSERT_ARY_IDX(gameFieldLow, m);
-		ASSERT_ARY_IDX(gameFieldHigh, m);
-		ASSERT_ARY_IDX(aniField, m);
-		ASSERT_ARY_IDX(ttlField, m);
-		gameFieldLow[m]  = fieldMap[k + 0]; /* tile index only (low byte) */
-		gameFieldHigh[m] = fieldMap[k + 1]; /* tile attributes only (high byte) */
-		aniField[m] = 0; /* initial animation frame number */
-		ttlField[m] = 0; /* initial animation time to live value */
-	}
-	/* randomize wall setup */
-	*((uint16_t *)(&lrngSeed)) = snes_vblank_count | 0x40; /* initialize seed; ensure != zero */
+	/* copy tile indices of the status rows from ROM */
+	ASSERT(sizeof(hudField) <= (uint16_t)(fieldMapLowEnd - fieldMapLow));
+	dmaCopyWram(fieldMapLow, hudField, sizeof(hudField));
+	if (playerCount > 2) {
+		/* players 3 and 4 use the upper status row; players 1 and 2 move to the lower one */
+		for (i = 0; i < MAX_PLAYERS; ++i) {
+			hudField[playerHudBombs[i] - 2] = CH_P;
+			hudField[playerHudBombs[i] - 1] = (uint8_t)(CH_1 + i);
+			hudField[playerHudBombs[i] + 0] = CH_1;
+			hudField[playerHudBombs[i] + 1] = CH_x;
+			hudField[playerHudRange[i] + 0] = CH_1;
+			hudField[playerHudRange[i] + 1] = CH_x;
+		}
+		updateHud(0, sizeof(hudField));
+	}
+	/* initialize the game field cells as in `fieldMapLow` (not listed fields are solid walls) */
+	dmaFillWram(fTypeCell + FTYPE_SOLID, cellMap, sizeof(cellMap));
+	dmaFillWram(fTypeCell + FTYPE_EMPTY, cellGfx, sizeof(cellGfx)); /* zero */
+	dirtyCellCount = 0;
+	/* the rows below `fieldMapLow` are rendered once the camera gets close to them */
+	streamRow = MAP_FIELD_ROWS;
+	ASSERT(ARRAY_SIZE(fieldElemIndex) <= CELL_LIST_SIZE);
+	for (i = 0; i < ARRAY_SIZE(fieldElemIndex); ++i) {
+		ASSERT_ARY_IDX(cellMap, fieldElemIndex[i]);
+		cellMap[fieldElemIndex[i]] = fTypeCell[(i < FIRST_FLEX_FIELD) ? FTYPE_EMPTY : FTYPE_BRICKED];
+	}
+	/* calculate all explosion ray lengths (updated by `setCell` from now on) */
+	for (k = 0; k < CELL_COUNT; ++k) {
+		rayLeft[k] = (uint8_t)(((k & 0x0F) == 0 || (cellMap[k - 1] & CELL_STOP)) ? 1 : rayLeft[k - 1] + 1);
+		rayUp[k] = (uint8_t)((k < 16 || (cellMap[k - 16] & CELL_STOP)) ? 1 : rayUp[k - 16] + 1);
+	}
+	for (k = CELL_COUNT; k-- > 0; ) {
+		rayRight[k] = (uint8_t)(((k & 0x0F) == 0x0F || (cellMap[k + 1] & CELL_STOP)) ? 1 : rayRight[k + 1] + 1);
+		rayDown[k] = (uint8_t)((k >= CELL_COUNT - 16 || (cellMap[k + 16] & CELL_STOP)) ? 1 : rayDown[k + 16] + 1);
+	}
+	/* randomize wall setup (see `seedRandom()`) */
 	for (i = FIRST_FLEX_FIELD; i < ARRAY_SIZE(fieldElemIndex); ++i) {
-		if ((lrng() & 7) >= 6) {
+		if ((lrngPop() & 7) >= 6) {
 			/* this field is not a wall (probability of 1/4) -> clear it */
-			field = gameFieldLow + fieldElemIndex[i];
-			clearField(field);
+			j = fieldElemIndex[i];
+			clearCell(j);
+		}
+	}
+	if (playerCount > 2) {
+		/* clear the start corners of player 3 and 4 (same wall setup for the other fields) */
+		for (i = 0; i < ARRAY_SIZE(startFields34); ++i) {
+			j = startFields34[i];
+			if ((cellMap[j] & CELL_TYPE) != FTYPE_EMPTY) {
+				clearCell(j);
+			}
+		}
+	}
+	saveMatch();
+	resetMatch();
+}
+
+
+/**
+ * Renders up to `MAX_RENDER_CELLS` changed game fields from `dirtyCells` to
+ * `renderTiles` for the VRAM transfer within the next VBlank. Remaining changed
+ * game fields are kept for the next frame. The game field rows which are not
+ * part of `fieldMapLow` are streamed one row per frame as soon as the camera
+ * gets close to them (see `CAMERA_ROW_AHEAD`).
+ *
+ * @remarks Uses `j`, `j2` and `tiles` internally.
+ * @remarks Shall be called at most once per frame before `WaitForVBlank()`.
+ */
+static void renderCells(void) {
+	PROFILE_BEGIN(PROF_RENDER);
+	if (streamRow < CELL_ROWS && streamRow <= CAMERA_ROW_AHEAD(cameraY) && dirtyCellCount <= (CELL_LIST_SIZE - 15)) {
+		/* queue the visible 15 cells of the row (the 16th would wrap into the next tile row) */
+		for (j = (uint8_t)(streamRow << 4); (j & 0x0F) != 0x0F; ++j) {
+			markCellDirty(j);
 		}
+		++streamRow;
+	}
+	for (renderCount = 0; renderCount < MAX_RENDER_CELLS && dirtyCellCount != 0; ++renderCount) {
+		--dirtyCellCount;
+		j = dirtyCells[dirtyCellCount];
+		ASSERT_ARY_IDX(cellMap, j);
+		cellMap[j] &= (uint8_t)(~CELL_DIRTY);
+		renderOffsets[renderCount] = CELL_INDEX(j);
+		tiles = renderTiles[renderCount];
+		/* upper left tile index of the graphic variant */
+		j2 = cellMap[j] & CELL_TYPE;
+		if (j2 == FTYPE_FLAME) {
+			ASSERT_ARY_IDX(shapeTile, GFX_SHAPE(cellGfx[j]));
+			j2 = shapeTile[GFX_SHAPE(cellGfx[j])];
+		} else {
+			ASSERT_ARY_IDX(fTypeTile, j2);
+			j2 = fTypeTile[j2];
+		}
+		j2 = (uint8_t)(j2 + (2 * GFX_FRAME(cellGfx[j])));
+		renderCellTiles();
+	}
+	PROFILE_END(PROF_RENDER);
+}
+
+
+/**
+ * Tests whether the given game field can be
+ * entered. This is true if the field is empty, a
+ * power-up or the bomb just placed.
+ *
+ * @param[in] player - instance of the player which tries to enter the field
+ * @param[in] cell - `cellMap` index of the game field
+ * @return true if accessible, else false
+ */
+static inline bool canEnter(const tPlayer * player, const uint8_t cell) {
+	ASSERT_ARY_IDX(cellMap, cell);
+	if ( ! (cellMap[cell] & CELL_BLOCKED) ) {
+		return true;
+	}
+	/* only the bomb just placed can be entered */
+	ASSERT_ARY_IDX(bombMap, cell);
+	return player->lastBombIdx != INVALID_BOMB && bombMap[cell] == player->lastBombIdx;
+}
+
+
+/**
+ * Tests whether an explosion is expected to reach the given game field.
+ *
+ * @param cell - `cellMap` index
+ */
+#define isDangerous(cell) \
+	((int16_t)(dangerTick[cell] - counter10Hz) >= 0)
+
+
+/**
+ * Lowers the danger time of the given game field to `dangerTime`. A bomb at
+ * this field would be triggered earlier. Hence, it is being queued for
+ * painting again.
+ *
+ * @param cell - `cellMap` index
+ */
+#define paintDangerCell(cell) \
+	ASSERT_ARY_IDX(dangerTick, cell); \
+	if ( ! isDangerous(cell) || (int16_t)(dangerTime - dangerTick[cell]) < 0 ) { \
+		dangerTick[cell] = dangerTime; \
+		if (bombMap[cell] != INVALID_BOMB) { \
+			queueDanger(bombMap[cell]); \
+		} \
+	}
+
+
+/**
+ * Adds the given `bombPool` entry to `dangerQueue` unless it is already
+ * queued. Nothing is queued in matches without CPU players.
+ *
+ * @param[in] idx - `bombPool` index
+ */
+static void queueDanger(const uint8_t idx) {
+	ASSERT_ARY_IDX(dangerQueued, idx);
+	if (cpuPlayers == 0 || dangerQueued[idx]) {
+		return;
+	}
+	ASSERT_ARY_IDX(dangerQueue, dangerQueueCount);
+	dangerQueued[idx] = true;
+	dangerQueue[dangerQueueCount] = idx;
+	++dangerQueueCount;
+}
+
+
+/**
+ * Paints the time of the explosion of the given `bombPool` entry into
+ * `dangerTick` along its four rays (see `handleExplosion()`). The time is
+ * lowered to that of an earlier explosion reaching the bomb.
+ *
+ * @param[in] idx - `bombPool` index
+ * @remarks Uses `j`, `m`, `bomb` and `dangerTime` internally.
+ */
+static void paintDanger(const uint8_t idx) {
+	ASSERT_ARY_IDX(bombPool, idx);
+	bomb = bombPool + idx;
+	if (bomb->owner == NULL || bombMap[bomb->cell] != idx) {
+		return; /* already exploded */
+	}
+	m = bomb->cell;
+	dangerTime = bomb->explodeTick;
+	if (isDangerous(m) && (int16_t)(dangerTick[m] - dangerTime) < 0) {
+		/* triggered by an earlier explosion */
+		dangerTime = dangerTick[m];
+	}
+	dangerTick[m] = dangerTime;
+	/* left */
+	j = (rayLeft[bomb->cell] < bomb->owner->range) ? rayLeft[bomb->cell] : bomb->owner->range;
+	for (m = bomb->cell - 1; j != 0; --j, --m) {
+		paintDangerCell(m);
+	}
+	/* right */
+	j = (rayRight[bomb->cell] < bomb->owner->range) ? rayRight[bomb->cell] : bomb->owner->range;
+	for (m = bomb->cell + 1; j != 0; --j, ++m) {
+		paintDangerCell(m);
+	}
+	/* up */
+	j = (rayUp[bomb->cell] < bomb->owner->range) ? rayUp[bomb->cell] : bomb->owner->range;
+	for (m = bomb->cell - 16; j != 0; --j, m -= 16) {
+		paintDangerCell(m);
+	}
+	/* down */
+	j = (rayDown[bomb->cell] < bomb->owner->range) ? rayDown[bomb->cell] : bomb->owner->range;
+	for (m = bomb->cell + 16; j != 0; --j, m += 16) {
+		paintDangerCell(m);
+	}
+}
+
+
+/**
+ * Paints up to `DANGER_BUDGET` queued bombs into `dangerTick`. All bombs are
+ * being queued again after explosions as these end the danger of their game
+ * fields and extend the rays of the other bombs.
+ *
+ * @remarks Uses `i`, `j`, `j2`, `m`, `bomb` and `dangerTime` internally.
+ */
+static void updateDanger(void) {
+	if ( dangerRescan ) {
+		dangerRescan = false;
+		for (i = 0; i < MAX_BOMB_POOL; ++i) {
+			if (bombPool[i].owner != NULL) {
+				queueDanger(i);
+			}
+		}
+	}
+	for (j2 = 0; j2 < DANGER_BUDGET && dangerQueueCount != 0; ++j2) {
+		--dangerQueueCount;
+		i = dangerQueue[dangerQueueCount];
+		dangerQueued[i] = false;
+		paintDanger(i);
+	}
+}
+
+
+/**
+ * Tests whether an explosion with the given range at the game field `from`
+ * reaches the game field `cell` (see `handleExplosion()`).
+ *
+ * @param[in] from - `cellMap` index of the bomb
+ * @param[in] cell - `cellMap` index of the game field in question
+ * @param[in] range - explosion range
+ * @return true if reached, else false
+ */
+static bool inBlast(const uint8_t from, const uint8_t cell, const uint8_t range) {
+	if (((from ^ cell) & 0xF0) == 0) {
+		/* same row */
+		if (cell < from) {
+			return (uint8_t)(from - cell) <= ((rayLeft[from] < range) ? rayLeft[from] : range);
+		}
+		return (uint8_t)(cell - from) <= ((rayRight[from] < range) ? rayRight[from] : range);
+	} else if (((from ^ cell) & 0x0F) == 0) {
+		/* same column */
+		if (cell < from) {
+			return (uint8_t)((uint8_t)(from - cell) >> 4) <= ((rayUp[from] < range) ? rayUp[from] : range);
+		}
+		return (uint8_t)((uint8_t)(cell - from) >> 4) <= ((rayDown[from] < range) ? rayDown[from] : range);
+	}
+	return false;
+}
+
+
+/**
+ * Starts the path search of the next CPU player after `searchPlayer` which
+ * is still in the match. Does nothing if there is none.
+ *
+ * @remarks Uses `j2` and `curPlayer` internally.
+ */
+static void startSearch(void) {
+	for (j2 = 0; j2 < MAX_PLAYERS; ++j2) {
+		searchPlayer = (uint8_t)((searchPlayer + 1) & (MAX_PLAYERS - 1));
+		if (players[searchPlayer].bit & alivePlayers & cpuPlayers) {
+			break;
+		}
+	}
+	if (j2 == MAX_PLAYERS) {
+		searchTail = 0; /* no CPU player left */
+		return;
+	}
+	/* new visited marker; clear the old ones only after all values have been used */
+	++searchId;
+	if (searchId == 0) {
+		memset(searchMark, 0, sizeof(searchMark));
+		searchId = 1;
+	}
+	curPlayer = players + searchPlayer;
+	searchStart = PIXEL_CELL(curPlayer->x + P_MID_X, curPlayer->y + P_MID_Y);
+	searchRange = curPlayer->range;
+	searchFoeCount = 0;
+	for (j2 = 0; j2 < playerCount; ++j2) {
+		if (j2 != searchPlayer && (players[j2].bit & alivePlayers)) {
+			searchFoes[searchFoeCount] = PIXEL_CELL(players[j2].x + P_MID_X, players[j2].y + P_MID_Y);
+			++searchFoeCount;
+		}
+	}
+	searchSafe = searchEscape = searchItem = searchTarget = searchLast = INVALID_CELL;
+	ASSERT_ARY_IDX(searchMark, searchStart);
+	searchMark[searchStart] = searchId;
+	searchFrom[searchStart] = searchStart;
+	searchDepth[searchStart] = 0;
+	searchQueue[0] = searchStart;
+	searchHead = 0;
+	searchTail = 1;
+}
+
+
+/**
+ * Adds the given neighbor of the game field `j` to the running path search
+ * unless it has been visited before, cannot be entered or explodes while the
+ * CPU player would cross it.
+ *
+ * @param cell - `cellMap` index
+ */
+#define searchVisit(cell) \
+	ASSERT_ARY_IDX(searchMark, cell); \
+	if (searchMark[cell] != searchId) { \
+		searchMark[cell] = searchId; \
+		if ( ! (cellMap[cell] & CELL_BLOCKED) && (cellMap[cell] & CELL_TYPE) != FTYPE_FLAME \
+			&& ( ! isDangerous(cell) || (uint16_t)(dangerTick[cell] - counter10Hz) > (uint16_t)((searchDepth[j] + 2) * CPU_CELL_TICKS)) ) { \
+			ASSERT_ARY_IDX(searchQueue, searchTail); \
+			searchFrom[cell] = j; \
+			searchDepth[cell] = (uint8_t)(searchDepth[j] + 1); \
+			searchQueue[searchTail] = (uint8_t)(cell); \
+			++searchTail; \
+		} \
+	}
+
+
+/**
+ * Turns the result of the completed path search into the decision of the
+ * CPU player `searchPlayer`. The player flees to the nearest safe game field
+ * if in danger. Else it collects the nearest power-up or walks to the nearest
+ * target. A bomb is only dropped at the target if a game field out of its
+ * reach is close enough.
+ *
+ * @remarks Uses `j`, `j2` and `cpu` internally.
+ */
+static void finishSearch(void) {
+	ASSERT_ARY_IDX(cpus, searchPlayer);
+	cpu = cpus + searchPlayer;
+	cpu->bombCell = INVALID_CELL;
+	if (searchSafe != searchStart) {
+		/* in danger */
+		j = searchSafe;
+	} else if (searchItem != INVALID_CELL) {
+		j = searchItem;
+	} else if (searchTarget == searchStart) {
+		j = searchLast;
+		if (players[searchPlayer].bombs && searchEscape != INVALID_CELL && searchDepth[searchEscape] <= CPU_ESCAPE_DIST) {
+			/* drop the bomb and walk out of its reach */
+			cpu->bombCell = searchStart;
+			j = searchEscape;
+		}
+	} else if (searchTarget != INVALID_CELL) {
+		j = searchTarget;
+	} else {
+		/* nothing in reach -> explore */
+		j = searchLast;
+	}
+	if (j == INVALID_CELL) {
+		cpu->pathLen = 0;
+		return;
+	}
+	/* collect the path from its end to the start */
+	cpu->pathLen = (uint8_t)(searchDepth[j] + 1);
+	cpu->pathPos = 0;
+	for (j2 = cpu->pathLen; j2-- > 0; j = searchFrom[j]) {
+		ASSERT_ARY_IDX(cpu->path, j2);
+		cpu->path[j2] = j;
+	}
+}
+
+
+/**
+ * Performs the given number of steps of the breadth-first path search
+ * from the game field of the CPU player `searchPlayer`. Each step classifies
+ * the next game field and adds its neighbors. The CPU players get their
+ * decisions in turns once their search has completed. Hence, a decision may
+ * be a few frames old. The cost per frame remains constant.
+ *
+ * @param[in] budget - maximum number of expanded cells (e.g. `CPU_SEARCH_BUDGET`)
+ * @remarks Uses `i`, `j`, `j2`, `k`, `cpu` and `curPlayer` internally.
+ */
+static void searchStep(const uint8_t budget) {
+	if (searchHead >= searchTail) {
+		startSearch();
+	}
+	for (i = 0; i < budget && searchHead < searchTail; ++i) {
+		ASSERT_ARY_IDX(searchQueue, searchHead);
+		j = searchQueue[searchHead];
+		++searchHead;
+		if ( ! isDangerous(j) && (cellMap[j] & CELL_TYPE) != FTYPE_FLAME ) {
+			/* safe game field */
+			if (searchSafe == INVALID_CELL) {
+				searchSafe = j;
+			}
+			if (searchEscape == INVALID_CELL && ! inBlast(searchStart, j, searchRange)) {
+				searchEscape = j;
+			}
+			if (searchItem == INVALID_CELL && (cellMap[j] & CELL_TOUCH)) {
+				searchItem = j;
+			}
+			if (searchTarget == INVALID_CELL) {
+				if ((cellMap[j - 1] & CELL_TYPE) == FTYPE_BRICKED || (cellMap[j + 1] & CELL_TYPE) == FTYPE_BRICKED
+					|| (cellMap[j - 16] & CELL_TYPE) == FTYPE_BRICKED || (cellMap[j + 16] & CELL_TYPE) == FTYPE_BRICKED) {
+					searchTarget = j;
+				}
+				for (j2 = 0; j2 < searchFoeCount; ++j2) {
+					if ( inBlast(j, searchFoes[j2], searchRange) ) {
+						searchTarget = j;
+					}
+				}
+			}
+			searchLast = j;
+		}
+		if (searchDepth[j] < CPU_PATH_LEN) {
+			/* the game field border is solid; no range checks needed */
+			k = j - 1;
+			searchVisit(k);
+			k = j + 1;
+			searchVisit(k);
+			k = j - 16;
+			searchVisit(k);
+			k = j + 16;
+			searchVisit(k);
+		}
+	}
+	if (searchHead >= searchTail && searchTail != 0) {
+		finishSearch();
+		searchTail = 0; /* start the next search with the next frame */
+	}
+}
+
+
+/**
+ * Refills `lrngPool` up to the scanline `IDLE_END_LINE`.
+ *
+ * @return false as the slice stops by itself
+ */
+static bool idleRandom(void) {
+	lrngFill(IDLE_END_LINE);
+	return false;
+}
+
+
+#if !defined(USE_REPLAY) && !defined(REC_REPLAY) && !defined(BENCH)
+/**
+ * Continues the running path search of the CPU players in idle time so
+ * that their decisions are available earlier. New searches are still
+ * started by `handleGame()` only. Disabled in deterministic builds as the
+ * decisions would depend on the idle time.
+ *
+ * @return true if the search is still running, else false
+ * @remarks Uses `i`, `j`, `j2`, `k`, `cpu` and `curPlayer` internally.
+ */
+static bool idleSearch(void) {
+	if (screen != S_GAME || cpuPlayers == 0 || searchTail == 0) {
+		return false;
+	}
+	searchStep(CPU_IDLE_BUDGET);
+	return searchTail != 0;
+}
+#endif /* not USE_REPLAY and not REC_REPLAY and not BENCH */
+
+
+/**
+ * Runs the slices of the tasks in `idleTasks` in order of their priority
+ * within the remaining frame time. A slice is only started if it ends
+ * before `IDLE_END_LINE` according to the longest slice measured so far
+ * (`idlePeak`). Nothing is started once the VBlank period has been reached.
+ *
+ * @remarks Called by `WaitForVBlank()`.
+ * @remarks Uses `idleIdx`, `idleMore`, `idleLine`, `idleEnd` and `idleFrame` internally.
+ */
+static void runIdleTasks(void) {
+	PROFILE_BEGIN(PROF_IDLE);
+	idleFrame = snes_vblank_count;
+	for (idleIdx = 0; idleIdx < ARRAY_SIZE(idleTasks); ++idleIdx) {
+		do {
+			idleLine = getScanline();
+			if (idleFrame != snes_vblank_count) {
+				/* VBlank period reached */
+				PROFILE_END(PROF_IDLE);
+				return;
+			}
+			if ((idleLine + idlePeak[idleIdx]) >= IDLE_END_LINE) {
+				/* no time left for this task */
+				break;
+			}
+			idleMore = idleTasks[idleIdx].run();
+			if ( idleTasks[idleIdx].lines ) {
+				idleEnd = getScanline();
+				if (idleFrame != snes_vblank_count) {
+					/* overrun into the VBlank period (the scanline counter wrapped unless still within it) */
+					if (idleEnd < VBLANK_LINE || (uint16_t)(snes_vblank_count - idleFrame) != 1) {
+						idleEnd = FRAME_LINES;
+					}
+					if (idleEnd < (VBLANK_LINE + IDLE_OVERRUN_LINES)) {
+						idleEnd = VBLANK_LINE + IDLE_OVERRUN_LINES;
+					}
+				}
+				idleLine = (uint16_t)(idleEnd - idleLine);
+				if (idleLine > 255) {
+					idleLine = 255;
+				}
+				if (idleLine > idlePeak[idleIdx]) {
+					idlePeak[idleIdx] = (uint8_t)idleLine;
+				}
+			}
+		} while ( idleMore );
 	}
-	/* initialize related variables */
-	p1.bombs = p2.bombs = 1;
-	p1.maxBombs = p2.maxBombs = 1;
-	p1.range = p2.range = 1;
-	p1.running = p2.running = 0;
-	p1.firstFrame = p2.firstFrame = ACT_DOWN;
-	p1.maxFrame = p2.maxFrame = 3;
-	p1.curFrame = p2.curFrame = ACT_DOWN;
-	p1.flipX = p2.flipX = 0;
-	p1.moveAniIdx = p2.moveAniIdx = 5;
-	p1.moving = p2.moving = 0;
-	p1.x = 2 * 8;
-	p1.y = 4 * 8;
-	p2.x = 26 * 8;
-	p2.y = 24 * 8;
-	for (i = 0; i < MAX_BOMBS; ++i) {
-		ASSERT_ARY_IDX(p1.bombList, i);
-		ASSERT_ARY_IDX(p2.bombList, i);
-		p1.bombList[i].ttl = 0;
-		p2.bombList[i].ttl = 0;
-	}
-	p1.lastBombIdx = p2.lastBombIdx = INVALID_LAST_BOMB_IDX;
-	dropRate255 = (uint8_t)((((uint16_t)dropRate) * 255) / 100);
-	gameOver = maxTime;
-	winner = WINNER_NA;
-	/* update remaining time on screen */
-	writeNumWithUnit(TILE_OFFSET(15, 1), 4, gameOver, CH_s);
-	/* update and show player sprites */
-	updatePlayerSprites();
-	/* the game screen is not yet visible */
-	setSpritesOffsetX(256);
-	oamSetVisible(P1_NR, OBJ_HIDE);
-	oamSetVisible(P2_NR, OBJ_HIDE);
+	PROFILE_END(PROF_IDLE);
 }
 
 
 /**
- * Tests whether the game field at `x`, `y` can be
- * entered. This is true if the field is empty, a
- * power-up or the bomb just placed.
+ * Returns the pad value of the given CPU player from its last decision. The
+ * player walks through the center of each game field of its path and drops
+ * a bomb at its target.
  *
- * @param[in] player - instance of the player which tries to enter the field
- * @return true if accessible, else false
+ * @param[in] player - CPU player instance
+ * @return pad value for `handlePlayer()`
+ * @remarks Uses `j`, `j2`, `k`, `dx`, `dy`, `x1`, `y1` and `cpu` internally.
  */
-static inline bool canEnter(const tPlayer * player) {
-	ASSERT_ARY_IDX(gameFieldLow, TILE_OFFSET_1(x, y));
-	ASSERT_ARY_IDX(fTypeMap, gameFieldLow[TILE_OFFSET_1(x, y)]);
-	switch (fTypeMap[gameFieldLow[TILE_OFFSET_1(x, y)]]) {
-	case FTYPE_EMPTY:
-	case FTYPE_PU_BOMB:
-	case FTYPE_PU_RANGE:
-	case FTYPE_PU_SPEED:
-	case FTYPE_FLAME:
-		return true;
-	case FTYPE_BOMB_P1:
-	case FTYPE_BOMB_P2:
-		if (player->lastBombIdx != INVALID_LAST_BOMB_IDX && player->bombList[player->lastBombIdx].ttl > 0 && player->bombList[player->lastBombIdx].x == x && player->bombList[player->lastBombIdx].y == y) {
-			ASSERT_ARY_IDX(player->bombList, player->lastBombIdx);
-			return true;
+static uint16_t cpuPad(const tPlayer * player) {
+	ASSERT_ARY_IDX(cpus, player->nr);
+	cpu = cpus + player->nr;
+	k = 0;
+	j = PIXEL_CELL(player->x + P_MID_X, player->y + P_MID_Y);
+	if (j == cpu->bombCell) {
+		cpu->bombCell = INVALID_CELL;
+		k = KEY_A;
+	}
+	/* skip the path fields already walked through (e.g. within an older decision) */
+	for (j2 = cpu->pathPos; j2 < cpu->pathLen; ++j2) {
+		if (cpu->path[j2] == j) {
+			cpu->pathPos = j2;
+			break;
 		}
-		/* fall-through */
-	default:
-		return false;
 	}
+	while (cpu->pathPos < cpu->pathLen) {
+		/* position with the collision box centered within the next game field */
+		ASSERT_ARY_IDX(cpu->path, cpu->pathPos);
+		x1 = (uint8_t)((cpu->path[cpu->pathPos] & 0x0F) << 4);
+		y1 = (uint8_t)((cpu->path[cpu->pathPos] & 0xF0) - 4);
+		dx = (int8_t)(x1 - player->x);
+		dy = (int8_t)(y1 - player->y);
+		if (dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1) {
+			++cpu->pathPos;
+			continue;
+		}
+		if (dx > 1) {
+			k |= KEY_RIGHT;
+		} else if (dx < -1) {
+			k |= KEY_LEFT;
+		}
+		if (dy > 1) {
+			k |= KEY_DOWN;
+		} else if (dy < -1) {
+			k |= KEY_UP;
+		}
+		break;
+	}
+	return k;
 }
 
 
@@ -1277,15 +2725,17 @@ static inline bool canEnter(const tPlayer * player) {
  * Handle the title screen and related events.
  */
 void handleTitle(void) {
-	if (pad0 & (KEY_START | KEY_A)) {
+	if (pads[0] & (KEY_START | KEY_A)) {
 		/* change to option screen */
 		bgSlideOut(FG_NR, INVALID_NR, false);
 		screen = S_OPTIONS;
 		option = O_TIME;
-		/* replace hidden second page */
-		dmaCopyVram(optionsMap, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE);
-		/* use `fg2Tiles` for the foreground map */
+		seedRandom();
+		/* replace second page (deferred until the slide-out has completed) */
+		vramQueueAdd(optionsMap, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE, VRAM_WORD);
 		updateOptionsScreen();
+		bgSlideWait();
+		/* use `fg2Tiles` for the foreground map */
 		bgSetGfxPtr(FG_NR, WORD_OFFSET(CHR_VRAM_FG2));
 		bgSlideIn(FG_NR, INVALID_NR, false);
 	}
@@ -1296,44 +2746,50 @@ void handleTitle(void) {
  * Handle the title options and related events.
  */
 void handleOptions(void) {
-	if (pad0 & (uint16_t)(KEY_SELECT | KEY_B)) {
+	if (pads[0] & (uint16_t)(KEY_SELECT | KEY_B)) {
 		/* change to title screen */
 		bgSlideOut(FG_NR, INVALID_NR, false);
 		screen = S_TITLE;
 		option = O_TIME;
-		/* replace second page */
-		dmaCopyVram(fg1Map, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE);
+		/* replace second page (deferred until the slide-out has completed) */
+		vramQueueAdd(fg1Map, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE, VRAM_WORD);
+		bgSlideWait();
 		/* use `fg1Tiles` for the foreground map */
 		bgSetGfxPtr(FG_NR, WORD_OFFSET(CHR_VRAM_FG1));
 		bgSlideIn(FG_NR, INVALID_NR, false);
-	} else if (pad0 & (KEY_START | KEY_A)) {
+	} else if (pads[0] & (KEY_START | KEY_A)) {
 		/* change to game screen */
 		bgSlideOut(FG_NR, BG_NR, false);
 		screen = S_GAME;
-		framesUntil10Hz = FP10HZ;
-		untilSecond = 10;
-		refreshGameScreenLow = false;
-		/* replace hidden second page */
-		dmaCopyVram(bg2Map, WORD_OFFSET(MAP_VRAM_BG + MAP_PAGE_SIZE), MAP_PAGE_SIZE);
-		dmaCopyVram(fieldMap, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE);
+		/* build the new game while the slide-out is running */
 		initializeGame();
-		WaitForVBlank(); /* ensure access to VRAM is possible */
-		/* update game field (only the tile indices) */
-		dmaCopyVramLowBytes(gameFieldLow, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), sizeof(gameFieldLow));
+		bgSlideWait();
+		/* replace second page */
+		vramQueueAdd(bg2Map, WORD_OFFSET(MAP_VRAM_BG + MAP_PAGE_SIZE), MAP_PAGE_SIZE, VRAM_WORD);
+		vramQueueAdd(fieldMapLow, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE / 2, VRAM_LOW);
+		vramQueueAdd(fieldMapHigh, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE / 2, VRAM_HIGH);
+		/* the field planes include the initial status rows */
+		updateHud(0, sizeof(hudField));
+		WaitForVBlank(); /* keep the game field update out of this VBlank */
+		/* transfer the randomized walls before the game field becomes visible */
+		while ( dirtyCellCount ) {
+			renderCells();
+			WaitForVBlank();
+		}
 		bgSlideIn(FG_NR, BG_NR, true);
-	} else if (pad0 & KEY_DOWN) {
+	} else if (pads[0] & KEY_DOWN) {
 		/* select option below */
 		ASSERT_ARY_IDX(optionBelow, option);
 		option = optionBelow[option];
 		updateOptionsScreen();
 		clickDelay();
-	} else if (pad0 & KEY_UP) {
+	} else if (pads[0] & KEY_UP) {
 		/* select option above */
 		ASSERT_ARY_IDX(optionAbove, option);
 		option = optionAbove[option];
 		updateOptionsScreen();
 		clickDelay();
-	} else if (pad0 & KEY_LEFT) {
+	} else if (pads[0] & KEY_LEFT) {
 		/* decrease selected value */
 		switch (option) {
 		case O_TIME:
@@ -1356,12 +2812,17 @@ void handleOptions(void) {
 				--maxRange;
 			}
 			break;
+		case O_HUMANS:
+			if (humanPlayers > 1) {
+				--humanPlayers;
+			}
+			break;
 		default:
 			break;
 		}
 		updateOptionsScreen();
 		clickDelay();
-	} else if (pad0 & KEY_RIGHT) {
+	} else if (pads[0] & KEY_RIGHT) {
 		/* increase selected value */
 		switch (option) {
 		case O_TIME:
@@ -1384,12 +2845,17 @@ void handleOptions(void) {
 				++maxRange;
 			}
 			break;
+		case O_HUMANS:
+			if (humanPlayers < playerCount) {
+				++humanPlayers;
+			}
+			break;
 		default:
 			break;
 		}
 		updateOptionsScreen();
 		clickDelay();
-	} else if (pad0 & KEY_X) {
+	} else if (pads[0] & KEY_X) {
 		/* reset selected value to its defaults */
 		switch (option) {
 		case O_TIME:
@@ -1404,6 +2870,9 @@ void handleOptions(void) {
 		case O_RANGE:
 			maxRange = DEF_MAX_RANGE;
 			break;
+		case O_HUMANS:
+			humanPlayers = playerCount;
+			break;
 		default:
 			break;
 		}
@@ -1419,62 +2888,54 @@ void handleOptions(void) {
  * @param[in] player - instance of the player in question
  * @param[in] xOffset - x offset from the upper left corner of the player sprite
  * @param[in] yOffset - y offset from the upper left corner of the player sprite
+ * @remarks Uses `j2` and `x` internally.
  */
 static void checkPlayerCollision(tPlayer * player, const uint8_t xOffset, const uint8_t yOffset) {
-	x = ((uint8_t)(player->x + xOffset) >> 3) & ~1;
-	y = ((uint8_t)(player->y + yOffset) >> 3) & ~1;
-	field = gameFieldLow + TILE_OFFSET_1(x, y);
-	ASSERT_ARY_PTR(gameFieldLow, field);
-	ASSERT_ARY_IDX(fTypeMap, *field);
-	switch (fTypeMap[*field]) {
+	j2 = PIXEL_CELL(player->x + xOffset, player->y + yOffset);
+	ASSERT_ARY_IDX(cellMap, j2);
+	if ( ! (cellMap[j2] & CELL_TOUCH) ) {
+		return; /* nothing to pick up or be hit by */
+	}
+	switch (cellMap[j2] & CELL_TYPE) {
 	case FTYPE_PU_BOMB:
 		if (player->maxBombs < maxBombs) {
 			++player->bombs;
 			++player->maxBombs;
 			ASSERT(player->bombs <= player->maxBombs);
 			/* update shown stats */
-			if (player == &p1) {
-				x = 3;
-			} else {
-				x = 23;
-			}
+			ASSERT_ARY_IDX(playerHudBombs, player->nr);
+			x = playerHudBombs[player->nr];
 			ASSERT_ARY_IDX(fg2NumText, player->maxBombs);
-			ASSERT_ARY_IDX(gameFieldLow, TILE_OFFSET(x, 1));
-			gameFieldLow[TILE_OFFSET(x, 1)] = fg2NumText[player->maxBombs];
-			refreshGameScreenLow = true;
+			ASSERT_ARY_IDX(hudField, x);
+			hudField[x] = fg2NumText[player->maxBombs];
+			updateHud(x, 1);
 		}
 		goto consumed;
 	case FTYPE_PU_RANGE:
 		if (player->range < maxRange) {
 			++player->range;
 			/* update shown stats */
-			if (player == &p1) {
-				x = 7;
-			} else {
-				x = 27;
-			}
+			ASSERT_ARY_IDX(playerHudRange, player->nr);
+			x = playerHudRange[player->nr];
 			ASSERT_ARY_IDX(fg2NumText, player->range);
-			ASSERT_ARY_IDX(gameFieldLow, TILE_OFFSET(x, 1));
-			gameFieldLow[TILE_OFFSET(x, 1)] = fg2NumText[player->range];
-			refreshGameScreenLow = true;
+			ASSERT_ARY_IDX(hudField, x);
+			hudField[x] = fg2NumText[player->range];
+			updateHud(x, 1);
 		}
 		goto consumed;
 	case FTYPE_PU_SPEED:
 		player->running = BOOTS_TTL;
 		goto consumed;
 	case FTYPE_FLAME:
-		if (player == &p1) {
-			winner |= WINNER_P2;
-		} else {
-			winner |= WINNER_P1;
-		}
+		/* leaves the match at the end of the frame (see `handleGame()`) */
+		hitPlayers |= player->bit;
 		break;
 	default:
 		break;
 	}
 	return;
 consumed:
-	clearField(field);
+	clearCell(j2);
 }
 
 
@@ -1488,35 +2949,26 @@ static void handlePlayer(const uint16_t pad, tPlayer * player) {
 	/* handle bomb drop */
 	if ((pad & KEY_A) && player->bombs) {
 		/* drop a bomb */
-		x = ((uint8_t)(player->x + P_MID_X) >> 3) & ~1;
-		y = ((uint8_t)(player->y + P_MID_Y) >> 3) & ~1;
-		field = gameFieldLow + TILE_OFFSET_1(x, y);
-		ASSERT_ARY_PTR(gameFieldLow, field);
-		if (*field == FIELD_EMPTY) {
+		j2 = PIXEL_CELL(player->x + P_MID_X, player->y + P_MID_Y);
+		ASSERT_ARY_IDX(cellMap, j2);
+		if ((cellMap[j2] & CELL_TYPE) == FTYPE_EMPTY) {
 			/* empty field -> drop bomb */
 			--player->bombs;
 			ASSERT(player->bombs <= player->maxBombs);
-			setField(field, FIELD_BOMB_P1);
-#ifndef NDEBUG
-			b = false;
-#endif /* NDEBUG */
-			for (i = 0; i < MAX_BOMBS; ++i) {
-				ASSERT_ARY_IDX(player->bombList, i);
-				if (player->bombList[i].ttl == 0) {
-					player->bombList[i].x = x;
-					player->bombList[i].y = y;
-					player->bombList[i].ttl = BOMB_TTL;
-					player->bombList[i].curFrame = 0;
-					player->bombList[i].ttlFrame = BOMB_ANIMATION;
-					player->lastBombIdx = i;
-#ifndef NDEBUG
-					b = true;
-#endif /* NDEBUG */
-					break;
-				}
-			}
-			ASSERT(b); /* added bomb to list? */
-			ASSERT_ARY_IDX(player->bombList, player->lastBombIdx);
+			setCell(j2, player->bombType, 0);
+			ASSERT(bombFreeCount != 0); /* unused bomb pool entry available? */
+			--bombFreeCount;
+			i = bombFree[bombFreeCount];
+			ASSERT_ARY_IDX(bombPool, i);
+			bomb = bombPool + i;
+			bomb->owner = player;
+			bomb->explodeTick = counter10Hz + BOMB_TTL;
+			bomb->cell = j2;
+			ASSERT_ARY_IDX(bombMap, j2);
+			bombMap[j2] = i;
+			linkBomb(i, counter10Hz + BOMB_ANIMATION);
+			player->lastBombIdx = i;
+			queueDanger(i);
 		}
 	}
 	/* handle player movement */
@@ -1539,21 +2991,15 @@ static void handlePlayer(const uint16_t pad, tPlayer * player) {
 		j = (uint8_t)(player->x + dx);
 		if (dx > 0) {
 			j2 = (uint8_t)(j + P_RIGHT);
-			x = (j2 >> 3) & ~1;
-			y = ((uint8_t)(player->y + P_TOP) >> 3) & ~1;
-			b = canEnter(player);
-			y = ((uint8_t)(player->y + P_BOTTOM) >> 3) & ~1;
-			if (b && canEnter(player)) {
+			b = canEnter(player, PIXEL_CELL(j2, player->y + P_TOP));
+			if (b && canEnter(player, PIXEL_CELL(j2, player->y + P_BOTTOM))) {
 				player->x = j;
 				refreshSprites = true;
 			}
 		} else if (dx < 0) {
 			j2 = (uint8_t)(j + P_LEFT);
-			x = (j2 >> 3) & ~1;
-			y = ((uint8_t)(player->y + P_TOP) >> 3) & ~1;
-			b = canEnter(player);
-			y = ((uint8_t)(player->y + P_BOTTOM) >> 3) & ~1;
-			if (b && canEnter(player)) {
+			b = canEnter(player, PIXEL_CELL(j2, player->y + P_TOP));
+			if (b && canEnter(player, PIXEL_CELL(j2, player->y + P_BOTTOM))) {
 				player->x = j;
 				refreshSprites = true;
 			}
@@ -1562,21 +3008,15 @@ static void handlePlayer(const uint16_t pad, tPlayer * player) {
 		j = (uint8_t)(player->y + dy);
 		if (dy > 0) {
 			j2 = (uint8_t)(j + P_BOTTOM);
-			x = ((uint8_t)(player->x + P_LEFT) >> 3) & ~1;
-			y = (j2 >> 3) & ~1;
-			b = canEnter(player);
-			x = ((uint8_t)(player->x + P_RIGHT) >> 3) & ~1;
-			if (b && canEnter(player)) {
+			b = canEnter(player, PIXEL_CELL(player->x + P_LEFT, j2));
+			if (b && canEnter(player, PIXEL_CELL(player->x + P_RIGHT, j2))) {
 				player->y = j;
 				refreshSprites = true;
 			}
 		} else if (dy < 0) {
 			j2 = (uint8_t)(j + P_TOP);
-			x = ((uint8_t)(player->x + P_LEFT) >> 3) & ~1;
-			y = (j2 >> 3) & ~1;
-			b = canEnter(player);
-			x = ((uint8_t)(player->x + P_RIGHT) >> 3) & ~1;
-			if (b && canEnter(player)) {
+			b = canEnter(player, PIXEL_CELL(player->x + P_LEFT, j2));
+			if (b && canEnter(player, PIXEL_CELL(player->x + P_RIGHT, j2))) {
 				player->y = j;
 				refreshSprites = true;
 			}
@@ -1609,17 +3049,17 @@ static void handlePlayer(const uint16_t pad, tPlayer * player) {
 		}
 		if ( player->moving ) {
 			/* exit from last bomb dropped handling */
-			if (player->lastBombIdx != INVALID_LAST_BOMB_IDX) {
-				ASSERT_ARY_IDX(player->bombList, player->lastBombIdx);
-				x = player->bombList[player->lastBombIdx].x;
-				y = player->bombList[player->lastBombIdx].y;
-				x1 = ((uint8_t)(player->x + P_LEFT)   >> 3) & ~1;
-				x2 = ((uint8_t)(player->x + P_RIGHT)  >> 3) & ~1;
-				y1 = ((uint8_t)(player->y + P_TOP)    >> 3) & ~1;
-				y2 = ((uint8_t)(player->y + P_BOTTOM) >> 3) & ~1;
+			if (player->lastBombIdx != INVALID_BOMB) {
+				ASSERT_ARY_IDX(bombPool, player->lastBombIdx);
+				x = bombPool[player->lastBombIdx].cell & 0x0F;
+				y = bombPool[player->lastBombIdx].cell >> 4;
+				x1 = (uint8_t)(player->x + P_LEFT)   >> 4;
+				x2 = (uint8_t)(player->x + P_RIGHT)  >> 4;
+				y1 = (uint8_t)(player->y + P_TOP)    >> 4;
+				y2 = (uint8_t)(player->y + P_BOTTOM) >> 4;
 				if ( ! (x1 <= x && x2 >= x && y1 <= y && y2 >= y) ) {
 					/* not over the last dropped bomb anymore -> disallow re-entering this field */
-					player->lastBombIdx = INVALID_LAST_BOMB_IDX;
+					player->lastBombIdx = INVALID_BOMB;
 				}
 			}
 		}
@@ -1631,62 +3071,46 @@ static void handlePlayer(const uint16_t pad, tPlayer * player) {
 }
 
 
+#ifdef USE_C_EXPLOSION
 /**
  * Handles a single exploded field. Uses the global
- * variables `x`, `y` as input for the coordinates
- * and `m` for the game field index. It also used
- * `j` to determine if this was the last exploded
- * field for the given direction.
- *
- * @param[in] attr - explosion field attribute
- * @param[in] part - explosion part tile index
- * @param[in] end - explosion end tile index
+ * variable `m` as input for the `cellMap` index.
+ * It also used `j` to determine if this was the
+ * last exploded field for the given direction.
+ *
+ * @param[in] flip - explosion graphic flags (`GFX_FLIP_X`, `GFX_FLIP_Y` or 0)
+ * @param[in] part - explosion part shape (`SHAPE_PART_X` or `SHAPE_PART_Y`)
  * @return true to continue, else false if the explosion was blocked
- * @remarks Uses `field` and `j2` internally.
- */
-static bool handleExplodedField(const uint8_t attr, const uint8_t part, const uint8_t end) {
-	ASSERT((x & 1) == 0);
-	ASSERT((y & 1) == 0);
-	ASSERT_ARY_IDX(gameFieldLow, m);
-	field = gameFieldLow + m;
-	ASSERT_ARY_IDX(fTypeMap, *field);
-	switch (fTypeMap[*field]) {
+ * @remarks Uses `j2` and `bomb` internally.
+ * @remarks The explosion end shape follows the explosion part shape.
+ */
+static bool handleExplodedField(const uint8_t flip, const uint8_t part) {
+	ASSERT_ARY_IDX(cellMap, m);
+	switch (cellMap[m] & CELL_TYPE) {
 	case FTYPE_EMPTY:
-		ASSERT_ARY_IDX(aniField, m);
-		aniField[m] = 4;
-		ttlField[m] = EXPLOSION_ANIMATION;
-		attrField = gameFieldHigh + m;
-		setFieldAttr(attrField, attr);
-		j2 = (j == 1) ? end : part;
-		if (attr & 0x80) {
-			setFieldFlippedY(field, j2);
-		} else if (attr & 0x40) {
-			setFieldFlippedX(field, j2);
-		} else {
-			setField(field, j2);
-		}
+		startCellAnimation(m);
+		j2 = (j == 1) ? (uint8_t)(part + 1) : part;
+		setCell(m, FTYPE_FLAME, CELL_GFX(flip, j2, 0));
 		return true;
 	case FTYPE_FLAME:
 		/* overlapping explosions */
-		ASSERT_ARY_IDX(aniField, m);
-		if (part == FIELD_EXPL_PART_X) {
+		j2 = GFX_SHAPE(cellGfx[m]);
+		if (part == SHAPE_PART_X) {
 			/* horizontal explosion */
-			if (*field >= FIELD_EXPL_PART_Y) {
+			if (j2 >= SHAPE_PART_Y) {
 				/* crossing vertical explosion */
 				goto explosionCross;
-			} else if (*field >= FIELD_EXPL_END_X) {
+			} else if (j2 >= SHAPE_END_X) {
 				/* hits end of horizontal explosion */
-				j2 = FIELD_EXPL_PART_X;
 				goto explosionExtend;
 			}
 		} else {
 			/* vertical explosion */
-			if (*field < FIELD_EXPL_PART_Y) {
+			if (j2 < SHAPE_PART_Y) {
 				/* crossing horizontal explosion */
 				goto explosionCross;
-			} else if (*field >= FIELD_EXPL_END_Y) {
+			} else if (j2 >= SHAPE_END_Y) {
 				/* hits end of vertical explosion */
-				j2 = FIELD_EXPL_PART_Y;
 				goto explosionExtend;
 			}
 		}
@@ -1695,47 +3119,26 @@ static bool handleExplodedField(const uint8_t attr, const uint8_t part, const ui
 	case FTYPE_PU_RANGE:
 	case FTYPE_PU_SPEED:
 		/* explosion ends here but destroys the power-up */
-		clearField(field);
+		clearCell(m);
 		/* fall-through */
 	case FTYPE_SOLID:
 		break;
 	case FTYPE_BOMB_P1:
-		/* chain reaction (may not trigger on circular chains) */
-		for (j2 = 0; j2 < MAX_BOMBS; ++j2) {
-			ASSERT_ARY_IDX(p1.bombList, j2);
-			if (p1.bombList[j2].ttl && p1.bombList[j2].x == x && p1.bombList[j2].y == y) {
-				++p1.bombs;
-				ASSERT(p1.bombs <= p1.maxBombs);
-				p1.bombList[j2].ttl = 0; /* prevent timeout to trigger also */
-				bombChain[bombChainCount].range = p1.range;
-				bombChain[bombChainCount].entry = p1.bombList + j2;
-				++bombChainCount;
-				break;
-			}
-		}
-		break;
 	case FTYPE_BOMB_P2:
-		/* chain reaction (may not trigger on circular chains) */
-		for (j2 = 0; j2 < MAX_BOMBS; ++j2) {
-			ASSERT_ARY_IDX(p2.bombList, j2);
-			if (p2.bombList[j2].ttl && p2.bombList[j2].x == x && p2.bombList[j2].y == y) {
-				++p2.bombs;
-				ASSERT(p2.bombs <= p2.maxBombs);
-				p2.bombList[j2].ttl = 0; /* prevent timeout to trigger also */
-				bombChain[bombChainCount].range = p2.range;
-				bombChain[bombChainCount].entry = p2.bombList + j2;
-				++bombChainCount;
-				break;
-			}
+		/* chain reaction (bombs already triggered are no longer in `bombMap`) */
+		ASSERT_ARY_IDX(bombMap, m);
+		j2 = bombMap[m];
+		if (j2 != INVALID_BOMB) {
+			unlinkBomb(j2); /* prevent timeout to trigger also */
+			triggerBomb(j2);
 		}
 		break;
 	case FTYPE_BRICKED:
-		ASSERT_ARY_IDX(aniField, m);
-		if (aniField[m] == 0) {
+		ASSERT_ARY_IDX(aniCell, m);
+		if (aniCell[m] == 0) {
 			/* if not already hit */
-			aniField[m] = 4;
-			ttlField[m] = EXPLOSION_ANIMATION;
-			setField(field, FIELD_BRICKED + 2);
+			startCellAnimation(m);
+			setCell(m, FTYPE_BRICKED, CELL_GFX(0, 0, 1));
 		}
 		break;
 	default:
@@ -1743,179 +3146,192 @@ static bool handleExplodedField(const uint8_t attr, const uint8_t part, const ui
 	}
 	return false;
 explosionCross:
-	aniField[m] = 4;
-	ttlField[m] = EXPLOSION_ANIMATION;
-	attrField = gameFieldHigh + m;
-	setFieldAttr(attrField, TILE_ATTR(0, 0, 1, 3));
-	setField(field, FIELD_EXPL_MID + (2 * (uint8_t)(4 - aniField[m])));
+	startCellAnimation(m);
+	setCell(m, FTYPE_FLAME, CELL_GFX(0, SHAPE_MID, 0));
 	return true;
 explosionExtend:
-	aniField[m] = 4;
-	ttlField[m] = EXPLOSION_ANIMATION;
-	attrField = gameFieldHigh + m;
-	setFieldAttr(attrField, attr);
-	j2 = j2 + (2 * (uint8_t)(4 - aniField[m]));
-	if (attr & 0x80) {
-		setFieldFlippedY(field, j2);
-	} else if (attr & 0x40) {
-		setFieldFlippedX(field, j2);
-	} else {
-		setField(field, j2);
-	}
+	startCellAnimation(m);
+	setCell(m, FTYPE_FLAME, CELL_GFX(flip, part, 0));
 	return true;
 }
 
 
 /**
- * Handles the explosion of a bomb at the given bomb list entry.
+ * Handles the explosion of a bomb at the given game field.
  *
  * @param[in] range - explosion range
- * @param[in,out] bombEntry - player bomb list entry pointer
- */
-static void handleExplosion(const uint8_t range, tBombField * bombEntry) {
-	x = bombEntry->x;
-	y = bombEntry->y;
-	k = TILE_OFFSET_1(x, y);
-	ASSERT_ARY_IDX(aniField, k);
-	ASSERT_ARY_IDX(ttlField, k);
-	aniField[k] = 4;
-	ttlField[k] = EXPLOSION_ANIMATION;
-	field = gameFieldLow + k;
-	setField(field, FIELD_EXPL_MID);
+ * @param[in] cell - `cellMap` index of the bomb
+ * @remarks Each direction is limited to its ray length (see `rayLeft`).
+ * @remarks The solid walls around the game field stop each direction before leaving `cellMap`.
+ */
+static void handleExplosion(const uint8_t range, const uint8_t cell) {
+	startCellAnimation(cell);
+	setCell(cell, FTYPE_FLAME, CELL_GFX(0, SHAPE_MID, 0));
 	/* going left */
-	for (j = range, m = k; j; --j) {
-		x -= 2; /* previous column */
-		m -= 2; /* previous column */
-		if ( ! handleExplodedField(TILE_ATTR(0, 1, 1, 3), FIELD_EXPL_PART_X, FIELD_EXPL_END_X) ) {
+	ASSERT_ARY_IDX(rayLeft, cell);
+	j = (rayLeft[cell] < range) ? rayLeft[cell] : range;
+	for (m = cell; j; --j) {
+		--m; /* previous column */
+		if ( ! handleExplodedField(GFX_FLIP_X, SHAPE_PART_X) ) {
 			break;
 		}
 	}
-	x = bombEntry->x;
 	/* going right */
-	for (j = range, m = k; j; --j) {
-		x += 2; /* next column */
-		m += 2; /* next column */
-		if ( ! handleExplodedField(TILE_ATTR(0, 0, 1, 3), FIELD_EXPL_PART_X, FIELD_EXPL_END_X) ) {
+	ASSERT_ARY_IDX(rayRight, cell);
+	j = (rayRight[cell] < range) ? rayRight[cell] : range;
+	for (m = cell; j; --j) {
+		++m; /* next column */
+		if ( ! handleExplodedField(0, SHAPE_PART_X) ) {
 			break;
 		}
 	}
-	x = bombEntry->x;
 	/* going up */
-	for (j = range, m = k; j; --j) {
-		y -= 2; /* previous row */
-		m -= 0x40; /* previous row */
-		if ( ! handleExplodedField(TILE_ATTR(1, 0, 1, 3), FIELD_EXPL_PART_Y, FIELD_EXPL_END_Y) ) {
+	ASSERT_ARY_IDX(rayUp, cell);
+	j = (rayUp[cell] < range) ? rayUp[cell] : range;
+	for (m = cell; j; --j) {
+		m -= 16; /* previous row */
+		if ( ! handleExplodedField(GFX_FLIP_Y, SHAPE_PART_Y) ) {
 			break;
 		}
 	}
-	y = bombEntry->y;
 	/* going down */
-	for (j = range, m = k; j; --j) {
-		y += 2; /* next row */
-		m += 0x40; /* next row */
-		if ( ! handleExplodedField(TILE_ATTR(0, 0, 1, 3), FIELD_EXPL_PART_Y, FIELD_EXPL_END_Y) ) {
+	ASSERT_ARY_IDX(rayDown, cell);
+	j = (rayDown[cell] < range) ? rayDown[cell] : range;
+	for (m = cell; j; --j) {
+		m += 16; /* next row */
+		if ( ! handleExplodedField(0, SHAPE_PART_Y) ) {
 			break;
 		}
 	}
 }
+#else /* not USE_C_EXPLOSION */
+/**
+ * Handles the explosion of a bomb at the given game field.
+ *
+ * @param[in] range - explosion range
+ * @param[in] cell - `cellMap` index of the bomb
+ * @remarks Uses `j`, `j2` and `bomb` internally.
+ * @remarks The game field update is performed by `explodeCells()`.
+ */
+static void handleExplosion(const uint8_t range, const uint8_t cell) {
+	explodeCells(cell, range);
+	/* chain reaction */
+	for (j = 0; j < explosionBombCount; ++j) {
+		j2 = explosionBombs[j];
+		unlinkBomb(j2); /* prevent timeout to trigger also */
+		triggerBomb(j2);
+	}
+}
+#endif /* not USE_C_EXPLOSION */
 
 
 /**
  * Handle the game screen and related events.
  */
 void handleGame(void) {
-	if ( refreshGameScreenLow ) {
-		/* update game field (only the tile indices) */
-		dmaCopyVramLowBytes(gameFieldLow, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), sizeof(gameFieldLow));
-		refreshGameScreenLow = false;
-	}
-	if ( refreshGameScreenHigh ) {
-		/* update game field (only the tile attributes) */
-		dmaCopyVramHighBytes(gameFieldHigh, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), sizeof(gameFieldHigh));
-		refreshGameScreenHigh = false;
-	}
-	/* update time related variables */
-	--framesUntil10Hz;
-	if (framesUntil10Hz == 0) {
-		framesUntil10Hz = FP10HZ;
-		++counter10Hz;
-		--untilSecond;
-		if (untilSecond == 0) {
-			untilSecond = 10;
-			--gameOver;
-			if (gameOver == 0) {
-				winner = WINNER_DRAW;
-			} else {
-				/* update remaining time on screen */
-				writeNumWithUnit(TILE_OFFSET(15, 1), 4, gameOver, CH_s);
-				refreshGameScreenLow = true;
+	if ( slideActive ) {
+		/* the game starts once the game field is fully visible */
+		resetGameClock();
+		return;
+	}
+	PROFILE_BEGIN(PROF_GAME);
+	/* advance the game clock by the frames elapsed since its last update */
+	frameDelta = (uint16_t)(snes_vblank_count - gameVBlank);
+	gameVBlank = snes_vblank_count;
+	if (frameDelta == 0) {
+		frameDelta = 1; /* first update within the frame of `resetGameClock()` */
+	}
+	frameStats.gameFrames += frameDelta;
+	if (frameDelta > 1) {
+		frameStats.lagFrames += frameDelta - 1;
+#ifndef NDEBUG
+		showLagFrames();
+#endif /* not NDEBUG */
+	}
+#if defined(USE_REPLAY) || defined(REC_REPLAY) || defined(BENCH)
+	/* one frame per main loop iteration to stay deterministic */
+	clockFrames = 1;
+#else /* not USE_REPLAY and not REC_REPLAY and not BENCH */
+	/* frames not caught up by the previous calls are carried over */
+	frameDelta += clockFrames;
+	if (frameDelta > (1 + MAX_CATCH_UP_FRAMES)) {
+		/* bounded catch-up */
+		frameStats.droppedFrames += frameDelta - (1 + MAX_CATCH_UP_FRAMES);
+		frameDelta = 1 + MAX_CATCH_UP_FRAMES;
+	}
+	clockFrames = (uint8_t)frameDelta;
+#endif /* not USE_REPLAY and not REC_REPLAY and not BENCH */
+	/* update time related variables (the work of each tick is split into phases; see `TICK_ANIMATION`) */
+	while (clockFrames != 0) {
+		--clockFrames;
+		--framesUntil10Hz;
+		/* at most one tick phase per call to keep the consecutive phases in separate frames */
+		tickPhase = (framesUntil10Hz == TICK_ANIMATION || framesUntil10Hz == TICK_BOMBS || framesUntil10Hz == TICK_EXPLOSIONS);
+		switch (framesUntil10Hz) {
+		case TICK_ANIMATION:
+			PROFILE_BEGIN(PROF_TICK);
+			framesUntil10Hz = FP10HZ;
+			++counter10Hz;
+			--untilSecond;
+			if (untilSecond == 0) {
+				untilSecond = 10;
+				--gameOver;
+				if (gameOver == 0) {
+					/* draw of all remaining players */
+					winner = alivePlayers;
+				} else {
+					/* update remaining time on screen */
+					writeNumWithUnit(TILE_OFFSET(15, 1), 4, gameOver, CH_s);
+				}
 			}
-		}
 #ifdef HAS_SFX
-		/* update remaining SFX1 playing time */
-		if ( sfx1Playing ) {
-			--sfx1Playing;
-		}
+			/* update remaining sound effect playing time */
+			if ( sfxRemaining ) {
+				--sfxRemaining;
+			}
 #endif /* HAS_SFX */
-		/* update running states */
-		if ( p1.running ) {
-			--p1.running;
-		}
-		if ( p2.running ) {
-			--p2.running;
-		}
-		/* update player 1 animation frame */
-		if ( p1.moving ) {
-			--p1.ttlFrame;
-			if (p1.ttlFrame == 0) {
-				p1.ttlFrame = PLAYER_ANIMATION;
-				++p1.curFrame;
-				if ((p1.curFrame - p1.firstFrame) >= p1.maxFrame) {
-					p1.curFrame = p1.firstFrame;
+			/* update running states and animation frames */
+			for (playerIdx = 0; playerIdx < playerCount; ++playerIdx) {
+				curPlayer = players + playerIdx;
+				if ( curPlayer->running ) {
+					--curPlayer->running;
 				}
-				refreshSprites = true;
-			}
-		}
-		/* update player 2 animation frame */
-		if ( p2.moving ) {
-			--p2.ttlFrame;
-			if (p2.ttlFrame == 0) {
-				p2.ttlFrame = PLAYER_ANIMATION;
-				++p2.curFrame;
-				if ((p2.curFrame - p2.firstFrame) >= p2.maxFrame) {
-					p2.curFrame = p2.firstFrame;
+				if ( curPlayer->moving ) {
+					--curPlayer->ttlFrame;
+					if (curPlayer->ttlFrame == 0) {
+						curPlayer->ttlFrame = PLAYER_ANIMATION;
+						++curPlayer->curFrame;
+						if ((curPlayer->curFrame - curPlayer->firstFrame) >= curPlayer->maxFrame) {
+							curPlayer->curFrame = curPlayer->firstFrame;
+						}
+						refreshSprites = true;
+					}
 				}
-				refreshSprites = true;
 			}
-		}
-		/* update animated game field frames */
-		for (i = 0; i < ARRAY_SIZE(fieldElemIndex); ++i) {
-			ASSERT_ARY_IDX(fieldElemIndex, i);
-			k = fieldElemIndex[i];
-			ASSERT_ARY_IDX(ttlField, k);
-			if ( ttlField[k] ) {
-				--ttlField[k];
-				if (ttlField[k] == 0) {
-					ASSERT_ARY_IDX(aniField, k);
-					--aniField[k];
-					ASSERT_ARY_IDX(gameFieldLow, k);
-					field = gameFieldLow + k;
-					if ( aniField[k] ) {
+			/* update animated game field frames */
+			for (i = 0; i < aniListCount; ) {
+				ASSERT_ARY_IDX(aniList, i);
+				j = aniList[i];
+				ASSERT_ARY_IDX(ttlCell, j);
+				--ttlCell[j];
+				if (ttlCell[j] == 0) {
+					ASSERT_ARY_IDX(aniCell, j);
+					--aniCell[j];
+					if ( aniCell[j] ) {
 						/* set next frame */
-						ttlField[k] = EXPLOSION_ANIMATION;
-						if (*field == (FIELD_BRICKED + 4)) {
+						ttlCell[j] = EXPLOSION_ANIMATION;
+						if ((cellMap[j] & CELL_TYPE) == FTYPE_BRICKED && GFX_FRAME(cellGfx[j]) == 2) {
 							/* toggling between both bricked animation frames */
-							setField(field, FIELD_BRICKED + 2);
+							setCell(j, FTYPE_BRICKED, CELL_GFX(0, 0, 1));
 						} else {
-							nextFieldFrame(field);
+							nextCellFrame(j);
 						}
 					} else {
 						/* field is clear again */
-						switch (*field) {
-						case FIELD_BRICKED + 2:
-						case FIELD_BRICKED + 4:
+						switch (cellMap[j] & CELL_TYPE) {
+						case FTYPE_BRICKED:
 							/* roll the power-up dice */
-							m = lrng();
+							m = lrngPop();
 							if ((uint8_t)m <= dropRate255) {
 								/* randomize power-up type */
 								switch (m & 0x0700) {
@@ -1923,150 +3339,166 @@ void handleGame(void) {
 								case 1 << 8:
 								case 2 << 8:
 								case 3 << 8:
-									setField(field, FIELD_PU_BOMB);
+									setCell(j, FTYPE_PU_BOMB, 0);
 									break;
 								case 4 << 8:
 								case 5 << 8:
 								case 6 << 8:
-									setField(field, FIELD_PU_RANGE);
+									setCell(j, FTYPE_PU_RANGE, 0);
 									break;
 								default:
-									setField(field, FIELD_PU_SPEED);
+									setCell(j, FTYPE_PU_SPEED, 0);
 									break;
 								}
 							} else {
-								clearField(field);
+								clearCell(j);
 							}
 							break;
 						default:
-							clearField(field);
+							clearCell(j);
 							break;
 						}
-						/* reset field attributes */
-						attrField = gameFieldHigh + k;
-						setFieldAttr(attrField, TILE_ATTR(0, 0, 1, 3));
+						/* remove from the active animation list (replace with last item) */
+						--aniListCount;
+						aniList[i] = aniList[aniListCount];
+						continue;
 					}
 				}
+				++i;
 			}
-		}
-		/* bomb handling */
-		bombChainCount = 0; /* reset list */
-		/* update player 1 bomb animation frames */
-		for (i = 0; i < MAX_BOMBS; ++i) {
-			ASSERT_ARY_IDX(p1.bombList, i);
-			if ( p1.bombList[i].ttl ) {
-				--p1.bombList[i].ttl;
-				if ( p1.bombList[i].ttl ) {
-					/* bomb did not explode yet */
-					--p1.bombList[i].ttlFrame;
-					if (p1.bombList[i].ttlFrame == 0) {
-						p1.bombList[i].ttlFrame = BOMB_ANIMATION;
-						p1.bombList[i].curFrame ^= 1;
-						field = gameFieldLow + TILE_OFFSET_1(p1.bombList[i].x, p1.bombList[i].y);
-						setField(field, FIELD_BOMB_P1 + (2 * p1.bombList[i].curFrame));
-					}
-				} else {
+			PROFILE_END(PROF_TICK);
+			break;
+		case TICK_BOMBS:
+			PROFILE_BEGIN(PROF_TICK);
+			/* bomb handling (only the bombs with an event scheduled for this tick) */
+			bombChainCount = 0; /* reset list */
+			k = counter10Hz & (BOMB_WHEEL_SIZE - 1);
+			i = bombWheel[k];
+			bombWheel[k] = INVALID_BOMB; /* each entry gets re-added or triggered */
+			while (i != INVALID_BOMB) {
+				ASSERT_ARY_IDX(bombPool, i);
+				bomb = bombPool + i;
+				j = bomb->next;
+				if (bomb->explodeTick == counter10Hz) {
 					/* bomb exploded */
-					++p1.bombs;
 #ifdef HAS_SFX
-					playSfx1();
+					queueSfx(SFX_EXPLOSION);
 #endif /* HAS_SFX */
-					ASSERT(p1.bombs <= p1.maxBombs);
-					handleExplosion(p1.range, p1.bombList + i);
-				}
-			}
-		}
-		/* update player 2 bomb animation frames */
-		for (i = 0; i < MAX_BOMBS; ++i) {
-			ASSERT_ARY_IDX(p2.bombList, i);
-			if ( p2.bombList[i].ttl ) {
-				--p2.bombList[i].ttl;
-				if ( p2.bombList[i].ttl ) {
-					/* bomb did not explode yet */
-					--p2.bombList[i].ttlFrame;
-					if (p2.bombList[i].ttlFrame == 0) {
-						p2.bombList[i].ttlFrame = BOMB_ANIMATION;
-						p2.bombList[i].curFrame ^= 1;
-						field = gameFieldLow + TILE_OFFSET_1(p2.bombList[i].x, p2.bombList[i].y);
-						setField(field, FIELD_BOMB_P2 + (2 * p2.bombList[i].curFrame));
-					}
+					triggerBomb(i);
 				} else {
-					/* bomb exploded */
-					++p2.bombs;
-#ifdef HAS_SFX
-					playSfx1();
-#endif /* HAS_SFX */
-					ASSERT(p2.bombs <= p2.maxBombs);
-					handleExplosion(p2.range, p2.bombList + i);
+					/* bomb did not explode yet -> show next animation frame */
+					ASSERT_ARY_IDX(cellGfx, bomb->cell);
+					cellGfx[bomb->cell] ^= 1;
+					markCellDirty(bomb->cell);
+					/* schedule the next animation frame or the explosion */
+					if ((uint16_t)(bomb->explodeTick - counter10Hz) > BOMB_ANIMATION) {
+						linkBomb(i, counter10Hz + BOMB_ANIMATION);
+					} else {
+						linkBomb(i, bomb->explodeTick);
+					}
 				}
+				i = j;
+			}
+			PROFILE_END(PROF_TICK);
+			break;
+		case TICK_EXPLOSIONS:
+			PROFILE_BEGIN(PROF_TICK);
+			/* handle explosions and chain reactions of the bombs triggered in this tick */
+			for (i = 0; i < bombChainCount; ++i) {
+				ASSERT_ARY_IDX(bombChain, i);
+				ASSERT_ARY_IDX(bombPool, bombChain[i].idx);
+				handleExplosion(bombChain[i].range, bombPool[bombChain[i].idx].cell);
+				freeBomb(bombChain[i].idx);
+			}
+			if (bombChainCount != 0) {
+				dangerRescan = true;
 			}
+			PROFILE_END(PROF_TICK);
+			break;
+		default:
+			break;
 		}
-		/* handle chain reactions */
-		for (i = 0; i < bombChainCount; ++i) {
-			ASSERT_ARY_IDX(bombChain, i);
-			handleExplosion(bombChain[i].range, bombChain[i].entry);
+		if ( tickPhase ) {
+			break;
 		}
 	}
-	/* handle user input */
-	if (pad0 & KEY_START) {
-#ifdef HAS_BGM
-		/* lower BGM volume */
-		spcSetModuleVolume(BGM_PAUSE_VOL);
-#endif /* HAS_BGM */
-		/* change to pause game screen */
-		pausePad = &pad0;
-		screen = S_PAUSE;
-		/* show stop icon */
-		changeClockIcon(true);
-		waitForKeyReleased(0, KEY_START);
-	} else if (pad1 & KEY_START) {
+	if ( cpuPlayers ) {
+		/* CPU players (fixed amount of work per frame) */
+		PROFILE_BEGIN(PROF_CPU);
+		updateDanger();
+		searchStep(CPU_SEARCH_BUDGET);
+		PROFILE_END(PROF_CPU);
+	}
+	/* handle user input (sampled as late as possible) */
+	latchPads();
+	PROFILE_SPAN_BEGIN(PROF_INPUT);
+	for (playerIdx = 0; playerIdx < playerCount; ++playerIdx) {
+		if (pads[playerIdx] & KEY_START) {
 #ifdef HAS_BGM
-		/* lower BGM volume */
-		spcSetModuleVolume(BGM_PAUSE_VOL);
+			/* lower BGM volume */
+			if ( audioStage == AUDIO_READY ) {
+				spcSetModuleVolume(BGM_PAUSE_VOL);
+			}
 #endif /* HAS_BGM */
-		/* change to pause game screen */
-		pausePad = &pad1;
-		screen = S_PAUSE;
-		/* show stop icon */
-		changeClockIcon(true);
-		waitForKeyReleased(0, KEY_START);
+			/* change to pause game screen */
+			pausePad = pads + playerIdx;
+			screen = S_PAUSE;
+			/* show stop icon */
+			changeClockIcon(true);
+			waitForKeyReleased(playerIdx, KEY_START);
+			break;
+		}
+	}
+	PROFILE_BEGIN(PROF_PLAYER);
+	for (playerIdx = 0; playerIdx < playerCount; ++playerIdx) {
+		if (players[playerIdx].bit & alivePlayers) {
+			if (players[playerIdx].bit & cpuPlayers) {
+				pads[playerIdx] = cpuPad(players + playerIdx);
+			}
+			handlePlayer(pads[playerIdx], players + playerIdx);
+		}
+	}
+	PROFILE_END(PROF_PLAYER);
+	if ( hitPlayers ) {
+		/* the hit players leave the match */
+		j = (uint8_t)(alivePlayers & ~hitPlayers);
+		if ((j & (j - 1)) == 0) {
+			/* the last remaining player wins or the players hit last share a draw */
+			winner = (j != 0) ? j : hitPlayers;
+			j = winner;
+		}
+		for (playerIdx = 0; playerIdx < playerCount; ++playerIdx) {
+			if ((alivePlayers & ~j) & players[playerIdx].bit) {
+				hideSprite(players[playerIdx].sprite);
+			}
+		}
+		alivePlayers = j;
+		hitPlayers = 0;
 	}
-	handlePlayer(pad0, &p1);
-	handlePlayer(pad1, &p2);
+	/* follow the players (committed together with the sprites) */
+	updateCamera(false);
 	if ( refreshSprites ) {
 		updatePlayerSprites();
 	}
 	if (winner != WINNER_NA) {
 		/* change to winner screen */
 		screen = S_WINNER;
-		/* draw result */
-		for (i = 0; i < 64; ++i) {
-			gameFieldLow[i] = FIELD_EMPTY;
-		}
-		switch (winner) {
-		case WINNER_P1:
-			gameFieldLow[TILE_OFFSET(13, 0)] = CH_P;
-			gameFieldLow[TILE_OFFSET(14, 0)] = CH_1;
-			oamSetVisible(P2_NR, OBJ_HIDE);
-			break;
-		case WINNER_P2:
-			gameFieldLow[TILE_OFFSET(13, 0)] = CH_P;
-			gameFieldLow[TILE_OFFSET(14, 0)] = CH_2;
-			oamSetVisible(P1_NR, OBJ_HIDE);
-			break;
-		case WINNER_DRAW:
-			gameFieldLow[TILE_OFFSET(13, 0)] = CH_P;
-			gameFieldLow[TILE_OFFSET(14, 0)] = CH_1;
-			gameFieldLow[TILE_OFFSET(13, 1)] = CH_P;
-			gameFieldLow[TILE_OFFSET(14, 1)] = CH_2;
-			break;
-		default:
-			break;
+		/* draw result (label of each winning player) */
+		memset(hudField, FIELD_EMPTY, sizeof(hudField));
+		for (playerIdx = 0, i = 0; playerIdx < playerCount; ++playerIdx) {
+			if (winner & players[playerIdx].bit) {
+				ASSERT_ARY_IDX(winnerHud, i);
+				hudField[winnerHud[i] + 0] = CH_P;
+				hudField[winnerHud[i] + 1] = (uint8_t)(CH_1 + playerIdx);
+				++i;
+			}
 		}
-		setField(gameFieldLow + TILE_OFFSET(15, 0), FIELD_TROPHY);
-		WaitForVBlank();
-		dmaCopyVramLowBytes(gameFieldLow, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), sizeof(gameFieldLow));
+		setHudIcon(TILE_OFFSET(15, 0), FIELD_TROPHY);
+		updateHud(0, sizeof(hudField));
 	}
+	/* render the changed game fields for the next VBlank */
+	renderCells();
+	PROFILE_END(PROF_GAME);
 }
 
 
@@ -2074,32 +3506,43 @@ void handleGame(void) {
  * Handle the pause game screen and related events.
  */
 void handlePause(void) {
-	if (pausePad == &pad0 && (pad0 & KEY_SELECT)) {
+	/* render the remaining changed game fields */
+	renderCells();
+	if (pausePad == pads && (pads[0] & KEY_SELECT)) {
 #ifdef HAS_BGM
 		/* reset BGM volume */
-		spcSetModuleVolume(BGM_NORMAL_VOL);
+		if ( audioStage == AUDIO_READY ) {
+			spcSetModuleVolume(BGM_NORMAL_VOL);
+		}
 #endif /* HAS_BGM */
 		/* change to options screen */
 		bgSlideOut(FG_NR, BG_NR, true);
 		screen = S_OPTIONS;
 		option = O_TIME;
-		/* replace hidden second page */
-		dmaCopyVram(bg1Map, WORD_OFFSET(MAP_VRAM_BG + MAP_PAGE_SIZE), MAP_PAGE_SIZE);
-		dmaCopyVram(optionsMap, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE);
-		oamSetVisible(P1_NR, OBJ_HIDE);
-		oamSetVisible(P2_NR, OBJ_HIDE);
+		seedRandom();
+		bgSlideWait();
+		/* the options screen is not scrolled */
+		cameraY = 0;
+		/* replace second page */
+		vramQueueAdd(bg1Map, WORD_OFFSET(MAP_VRAM_BG + MAP_PAGE_SIZE), MAP_PAGE_SIZE, VRAM_WORD);
+		vramQueueAdd(optionsMap, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE, VRAM_WORD);
+		hidePlayerSprites();
 		updateOptionsScreen();
 		bgSlideIn(FG_NR, BG_NR, false);
 	} else if (*pausePad & KEY_START) {
 #ifdef HAS_BGM
 		/* reset BGM volume */
-		spcSetModuleVolume(BGM_NORMAL_VOL);
+		if ( audioStage == AUDIO_READY ) {
+			spcSetModuleVolume(BGM_NORMAL_VOL);
+		}
 #endif /* HAS_BGM */
 		/* change to game screen */
 		screen = S_GAME;
 		/* show stop icon */
 		changeClockIcon(false);
 		waitForKeyReleased(0, KEY_START);
+		/* the paused frames are no lag frames */
+		resetGameClock();
 	}
 }
 
@@ -2108,19 +3551,300 @@ void handlePause(void) {
  * Handle the show winner screen and related events.
  */
 void handleWinner(void) {
-	if (pad0 & (uint16_t)(KEY_START | KEY_SELECT)) {
+	/* render the remaining changed game fields */
+	renderCells();
+	if (pads[0] & (uint16_t)(KEY_START | KEY_SELECT)) {
 		/* change to options screen */
 		bgSlideOut(FG_NR, BG_NR, true);
 		screen = S_OPTIONS;
 		option = O_TIME;
-		/* replace hidden second page */
-		dmaCopyVram(bg1Map, WORD_OFFSET(MAP_VRAM_BG + MAP_PAGE_SIZE), MAP_PAGE_SIZE);
-		dmaCopyVram(optionsMap, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE);
-		oamSetVisible(P1_NR, OBJ_HIDE);
-		oamSetVisible(P2_NR, OBJ_HIDE);
+		seedRandom();
+		bgSlideWait();
+		/* the options screen is not scrolled */
+		cameraY = 0;
+		/* replace second page */
+		vramQueueAdd(bg1Map, WORD_OFFSET(MAP_VRAM_BG + MAP_PAGE_SIZE), MAP_PAGE_SIZE, VRAM_WORD);
+		vramQueueAdd(optionsMap, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE, VRAM_WORD);
+		hidePlayerSprites();
 		updateOptionsScreen();
 		bgSlideIn(FG_NR, BG_NR, false);
+	} else if (pads[0] & KEY_A) {
+		/* rematch on the same game field without leaving the game screen */
+		restoreMatch();
+		updateHud(0, sizeof(hudField));
+		/* transfer the restored game field before the match starts */
+		while ( dirtyCellCount ) {
+			renderCells();
+			WaitForVBlank();
+		}
+		setSpritesOffsetX(0);
+		screen = S_GAME;
+		/* do not drop a bomb right away */
+		waitForKeyReleased(0, KEY_A);
+		resetGameClock();
+	}
+}
+
+
+#ifdef BENCH
+/**
+ * Returns the position of the given scanline relative to the start of the
+ * vertical blank, i.e. the increment of `snes_vblank_count`.
+ *
+ * @param[in] line - scanline
+ * @return relative scanline
+ */
+#define benchLinePos(line) \
+	(((line) >= VBLANK_LINE) ? (uint16_t)((line) - VBLANK_LINE) : (uint16_t)((line) + FRAME_LINES - VBLANK_LINE))
+
+
+/**
+ * Places a bomb of the given player with the given explosion tick.
+ *
+ * @param[in] player - owner of the bomb
+ * @param[in] cell - `cellMap` index of an empty game field element
+ * @param[in] tick - `counter10Hz` value of the explosion
+ * @remarks Uses `j2` and `bomb` internally.
+ */
+static void placeBenchBomb(tPlayer * player, const uint8_t cell, const uint16_t tick) {
+	ASSERT_ARY_IDX(cellMap, cell);
+	ASSERT(player->bombs != 0);
+	--player->bombs;
+	setCell(cell, player->bombType, 0);
+	ASSERT(bombFreeCount != 0);
+	--bombFreeCount;
+	j2 = bombFree[bombFreeCount];
+	ASSERT_ARY_IDX(bombPool, j2);
+	bomb = bombPool + j2;
+	bomb->owner = player;
+	bomb->explodeTick = tick;
+	bomb->cell = cell;
+	bombMap[cell] = j2;
+	if ((uint16_t)(tick - counter10Hz) > BOMB_ANIMATION) {
+		linkBomb(j2, counter10Hz + BOMB_ANIMATION);
+	} else {
+		linkBomb(j2, tick);
+	}
+	queueDanger(j2);
+}
+
+
+/**
+ * Initializes the game for the benchmark scenario `benchIdx`.
+ *
+ * @remarks Uses `i`, `j`, `j2`, `k` and `bomb` internally.
+ */
+static void setupBenchScenario(void) {
+	maxTime = 990; /* no time out */
+	playerCount = MAX_PLAYERS; /* worst case regardless of the connected controllers */
+	humanPlayers = (benchIdx == BENCH_CPU) ? 0 : MAX_PLAYERS;
+	dropRate = (benchIdx == BENCH_BRICKS) ? 100 : DEF_DROP_RATE;
+	maxBombs = MAX_BOMBS;
+	maxRange = MAX_RANGE;
+	seedRandom();
+	initializeGame();
+	for (i = 0; i < MAX_PLAYERS; ++i) {
+		players[i].bombs = MAX_BOMBS;
+		players[i].maxBombs = MAX_BOMBS;
+		players[i].range = MAX_RANGE;
+	}
+	if (benchIdx != BENCH_BRICKS && benchIdx != BENCH_CPU) {
+		/* clear all walls */
+		for (i = FIRST_FLEX_FIELD; i < ARRAY_SIZE(fieldElemIndex); ++i) {
+			j = fieldElemIndex[i];
+			clearCell(j);
+		}
+	}
+	switch (benchIdx) {
+	case BENCH_BOMBS:
+	case BENCH_CHAIN:
+		/* players 1 and 2 in positions out of reach of their explosions (see `runBenchmark()` for hits) */
+		players[0].x = 4 * 8;
+		players[0].y = 8 * 8;
+		players[1].x = 24 * 8;
+		players[1].y = 20 * 8;
+		updatePlayerSprites();
+		setSpritesOffsetX(256);
+		for (i = 0; i < ARRAY_SIZE(benchBombCells); ++i) {
+			/* only the first bomb times out in the chain reaction scenario */
+			k = (benchIdx == BENCH_CHAIN && i != 0) ? BOMB_TTL : BENCH_FUSE;
+			placeBenchBomb(players + (i / MAX_BOMBS), benchBombCells[i], counter10Hz + k);
+		}
+		break;
+	case BENCH_BRICKS:
+		/* restore and break all walls */
+		for (i = FIRST_FLEX_FIELD; i < ARRAY_SIZE(fieldElemIndex); ++i) {
+			j = fieldElemIndex[i];
+			startCellAnimation(j);
+			setCell(j, FTYPE_BRICKED, CELL_GFX(0, 0, 1));
+		}
+		break;
+	case BENCH_BOOTS:
+		for (i = 0; i < MAX_PLAYERS; ++i) {
+			players[i].running = BOOTS_TTL;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+/**
+ * Runs all benchmark scenarios for `BENCH_FRAMES` frames each and stores the
+ * measured frame costs and lag frames in `benchResult`. Sets `benchDone` at
+ * the end and never returns.
+ */
+static void runBenchmark(void) {
+	/* game screen without title and options screen */
+	screen = S_GAME;
+	vramQueueAdd(bg2Map, WORD_OFFSET(MAP_VRAM_BG + MAP_PAGE_SIZE), MAP_PAGE_SIZE, VRAM_WORD);
+	vramQueueAdd(fieldMapLow, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE / 2, VRAM_LOW);
+	vramQueueAdd(fieldMapHigh, WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), MAP_PAGE_SIZE / 2, VRAM_HIGH);
+	bgSetGfxPtr(FG_NR, WORD_OFFSET(CHR_VRAM_FG2));
+	WaitForVBlank();
+	for (benchIdx = 0; benchIdx < BENCH_SCENARIOS; ++benchIdx) {
+		setupBenchScenario();
+		if (benchIdx != BENCH_BRICKS) {
+			/* the initial game field is not part of the measurement */
+			while ( dirtyCellCount ) {
+				renderCells();
+				WaitForVBlank();
+			}
+		}
+		bgSlideIn(FG_NR, BG_NR, true);
+		bgSlideWait();
+		benchResult[benchIdx].minCost = 0xFFFF;
+		benchResult[benchIdx].maxCost = 0;
+		benchResult[benchIdx].lagFrames = 0;
+		benchSum = 0;
+		resetGameClock();
+		for (benchFrame = 0; benchFrame < BENCH_FRAMES; ++benchFrame) {
+			benchCount = snes_vblank_count;
+			benchLine = getScanline();
+			if (benchIdx == BENCH_BOOTS) {
+				/* run back and forth along the upper and lower row */
+				pads[0] = pads[3] = (benchFrame & 0x40) ? KEY_LEFT : KEY_RIGHT;
+				pads[1] = pads[2] = (benchFrame & 0x40) ? KEY_RIGHT : KEY_LEFT;
+			} else {
+				pads[0] = pads[1] = pads[2] = pads[3] = 0;
+			}
+			handleGame();
+			/* frame cost up to the point the frame is ready for VBlank */
+			k = getScanline();
+			benchCost = (uint16_t)((uint16_t)(snes_vblank_count - benchCount) * FRAME_LINES + benchLinePos(k) - benchLinePos(benchLine));
+			benchSum += benchCost;
+			if (benchCost < benchResult[benchIdx].minCost) {
+				benchResult[benchIdx].minCost = benchCost;
+			}
+			if (benchCost > benchResult[benchIdx].maxCost) {
+				benchResult[benchIdx].maxCost = benchCost;
+			}
+			/* scenarios keep running even if a player got hit */
+			screen = S_GAME;
+			winner = WINNER_NA;
+			alivePlayers = (uint8_t)((1 << MAX_PLAYERS) - 1);
+			WaitForVBlank();
+			k = (uint16_t)(snes_vblank_count - benchCount);
+			if (k > 1) {
+				benchResult[benchIdx].lagFrames += k - 1;
+			}
+		}
+		benchResult[benchIdx].avgCost = (uint16_t)(benchSum >> BENCH_FRAMES_LOG2);
+	}
+	benchDone = 1;
+	for (;;) {
+		WaitForVBlank();
+	}
+}
+#endif /* BENCH */
+
+
+/**
+ * Updates `pads` for the next main loop iteration. The values are taken from
+ * `replayData` if built with `USE_REPLAY` and recorded to `replayBuffer` if
+ * built with `REC_REPLAY`. Replays cover the first two players only.
+ *
+ * @remarks The replay advances per main loop iteration, not per frame.
+ */
+static inline void readPads(void) {
+#ifdef USE_REPLAY
+	if (replayCount == 0) {
+		/* next replay entry (no input after the end) */
+		pads[0] = pads[1] = 0;
+		if ((const uint8_t *)replayEntry < replayDataEnd && replayEntry->count != 0) {
+			pads[0] = replayEntry->pad0;
+			pads[1] = replayEntry->pad1;
+			replayCount = replayEntry->count;
+			++replayEntry;
+		}
+	}
+	if ( replayCount ) {
+		--replayCount;
+	}
+#else /* not USE_REPLAY */
+	/* scanPads() or scanMPlay5() gets called in handleVBlank() which is registered as NMI handler */
+	pads[0] = padsCurrent(0);
+	pads[1] = padsCurrent(1);
+	if (playerCount > 2) {
+		pads[2] = padsCurrent(2);
+		pads[3] = padsCurrent(3);
+	}
+#ifdef REC_REPLAY
+	if (replayRecordCount != 0
+		&& replayBuffer[replayRecordCount - 1].pad0 == pads[0]
+		&& replayBuffer[replayRecordCount - 1].pad1 == pads[1]
+		&& replayBuffer[replayRecordCount - 1].count != 0xFFFF) {
+		/* same pad values as before */
+		++replayBuffer[replayRecordCount - 1].count;
+	} else if ((replayRecordCount + 1) < ARRAY_SIZE(replayBuffer)) {
+		/* changed pad values (stops recording if full) */
+		replayBuffer[replayRecordCount].pad0 = pads[0];
+		replayBuffer[replayRecordCount].pad1 = pads[1];
+		replayBuffer[replayRecordCount].count = 1;
+		++replayRecordCount;
+		replayBuffer[replayRecordCount].count = 0; /* end marker */
+	}
+#endif /* REC_REPLAY */
+#endif /* not USE_REPLAY */
+}
+
+
+/**
+ * VBlank handler replacing `consoleVblank()` as NMI handler. Advances the
+ * active slide and transfers the changed sprites and the VRAM updates queued
+ * within the last completed frame. Reads the pads and counts the VBlank like
+ * `consoleVblank()` but without its full object attribute memory upload.
+ */
+static void handleVBlank(void) {
+	slideStep();
+	if ( frameReady ) {
+		PROFILE_SPAN_END(PROF_INPUT);
+		PROFILE_BEGIN(PROF_VBLANK);
+		spriteFlush();
+		/* the target page remains visible until a slide-out has completed */
+		if ( ! (slideActive && slideSpeed < 0) ) {
+			vramQueueFlush();
+			if ( renderCount ) {
+				/* update the rendered game field elements */
+				dmaCopyVramCells(renderTiles[0], WORD_OFFSET(MAP_VRAM_FG + MAP_PAGE_SIZE), renderOffsets, renderCount);
+				renderCount = 0;
+			}
+			/* scroll the game field below the status rows */
+			setSplitScroll(HUD_LINES, VERT_OFFSET, (uint16_t)(VERT_OFFSET + cameraY));
+			frameReady = false;
+		}
+		PROFILE_END(PROF_VBLANK);
+	} else if ( slideActive ) {
+		/* the sprites follow the slide even if the frame is not yet complete */
+		spriteFlush();
 	}
+	if ( snes_mplay5 ) {
+		scanMPlay5();
+	} else {
+		scanPads();
+	}
+	++snes_vblank_count;
 }
 
 
@@ -2128,60 +3852,79 @@ void handleWinner(void) {
  * Main entry point.
  */
 int main(void) {
-#if defined(HAS_BGM) || defined(HAS_SFX)
-	/* initialize sound engine (slow) */
-	spcBoot();
-#endif /* HAS_BGM or HAS_SFX */
+#ifdef USE_FASTROM
+	/* this function is already called via the fast bank mirror (see `hdr.asm`) */
+	fastRomInit();
+#endif /* USE_FASTROM */
 
 	/* initialize SNES */
 	consoleInit();
+	/* perform queued VRAM updates within the VBlank handler */
+	nmiSet(handleVBlank);
 
-#ifdef HAS_BGM
-	/* set soundbank available in bgm1.asm in reverse order */
-	spcSetBank(&SOUNDBANK__1);
-	spcSetBank(&SOUNDBANK__0);
-#endif /* HAS_BGM */
-
-#ifdef HAS_SFX
-	/* allocate sound ram (18x 256-byte blocks) */
-	spcAllocateSoundRegion(18);
-#endif /* HAS_SFX */
-
+#if defined(HAS_BGM) || defined(HAS_SFX)
+	/* the sound driver and data are uploaded while the title screen runs (see `bootAudioStep()`) */
+	audioStage = AUDIO_BOOT;
+#endif /* HAS_BGM or HAS_SFX */
 #ifdef HAS_SFX
-	/* load sound effect */
-	spcSetSoundEntry(15, 7, 5, (sfx1End - sfx1), sfx1, sfx1Sample);
-	sfx1Playing = 0;
+	sfxQueueCount = 0;
+	sfxQueued = 0;
+	sfxPlaying = SFX_COUNT;
+	sfxRemaining = 0;
 #endif /* HAS_SFX */
 
-#ifdef HAS_BGM
-	/* load the background music using the ID defined in `bgm1.h` */
-	spcLoad(MOD_BGM1);
-#endif /* HAS_BGM */
-
 	/* SNES background layer map for the background with two pages of 32x32 tiles */
 	bgSetMapPtr(BG_NR, WORD_OFFSET(MAP_VRAM_BG), SC_64x32);
 	/* SNES background layer map for the foreground with two pages of 32x32 tiles */
 	bgSetMapPtr(FG_NR, WORD_OFFSET(MAP_VRAM_FG), SC_64x32);
 
-	/* copy foreground/background tiles and palettes to VRAM */
-	bgInitTileSet(BG_NR, bg1Tiles, bg1Pal, 1, (bg1TilesEnd - bg1Tiles), (bg1PalEnd - bg1Pal), BG_16COLORS, WORD_OFFSET(CHR_VRAM_BG1));
-	bgInitTileSet(FG_NR, fg1Tiles, fg1Pal, 2, (fg1TilesEnd - fg1Tiles), (fg1PalEnd - fg1Pal), BG_16COLORS, WORD_OFFSET(CHR_VRAM_FG1));
-	bgInitTileSet(FG_NR, fg2Tiles, fg2Pal, 3, (fg2TilesEnd - fg2Tiles), (fg2PalEnd - fg2Pal), BG_16COLORS, WORD_OFFSET(CHR_VRAM_FG2));
-	bgSetGfxPtr(FG_NR, WORD_OFFSET(CHR_VRAM_FG1));
-
-	/* copy sprite tiles and palettes to VRAM */
-	oamInitGfxSet(p12Tiles, (p12TilesEnd - p12Tiles), p12Pal, (p12PalEnd - p12Pal), 4, WORD_OFFSET(CHR_VRAM_P1), OBJ_SIZE16_L32);
-
-	/* set sprite parameters */
-	oamSet(P1_NR, 0, 0, 3, 0, 0, playerTileMap[ACT_DOWN], 4);
-	oamSet(P2_NR, 0, 0, 3, 0, 0, playerTileMap[ACT_DOWN], 5);
-	oamSetEx(P1_NR, OBJ_SMALL, OBJ_HIDE);
-	oamSetEx(P2_NR, OBJ_SMALL, OBJ_HIDE);
-
-	/* disable screen and wait for VBlank to allow VRAM updates */
+	/* disable screen and wait for VBlank to allow the uploads below */
 	setBrightness(0);
 	WaitForVBlank();
 
+	/* decompress foreground/background tiles to VRAM and copy their palettes */
+	lzCopyVram(bg1TilesLz, WORD_OFFSET(CHR_VRAM_BG1));
+	dmaCopyCGram(bg1Pal, 1 * BG_16COLORS, (bg1PalEnd - bg1Pal));
+	lzCopyVram(fg1TilesLz, WORD_OFFSET(CHR_VRAM_FG1));
+	dmaCopyCGram(fg1Pal, 2 * BG_16COLORS, (fg1PalEnd - fg1Pal));
+	lzCopyVram(fg2TilesLz, WORD_OFFSET(CHR_VRAM_FG2));
+	dmaCopyCGram(fg2Pal, 3 * BG_16COLORS, (fg2PalEnd - fg2Pal));
+	bgSetGfxPtr(BG_NR, WORD_OFFSET(CHR_VRAM_BG1));
+	bgSetGfxPtr(FG_NR, WORD_OFFSET(CHR_VRAM_FG1));
+
+	/* decompress sprite tiles to VRAM and copy their palettes */
+	lzCopyVram(p12TilesLz, WORD_OFFSET(CHR_VRAM_P1));
+	dmaCopyCGram(p12Pal, 128 + 4 * 16, (p12PalEnd - p12Pal));
+	/* derive the palettes of player 3 and 4 by rotating the color channels */
+	for (i = 0; i < ARRAY_SIZE(p34Pal); ++i) {
+		k = ((uint16_t *)p12Pal)[i];
+		p34Pal[i] = (uint16_t)(((k << 5) & 0x7FE0) | ((k >> 10) & 0x1F));
+	}
+	dmaCopyCGram((uint8_t *)p34Pal, 128 + 6 * 16, sizeof(p34Pal));
+	oamInitGfxAttr(WORD_OFFSET(CHR_VRAM_P1), OBJ_SIZE16_L32);
+
+	/* decompress the tile maps used via the VRAM transfer queue */
+	lzCopyWram(bg1MapLz, bg1Map);
+	lzCopyWram(bg2MapLz, bg2Map);
+	lzCopyWram(fg1MapLz, fg1Map);
+	lzCopyWram(optionsMapLz, optionsMap);
+
+	/* take the player sprites (hidden until the game starts) */
+	initSprites();
+	for (i = 0; i < MAX_PLAYERS; ++i) {
+		players[i].sprite = allocSprite();
+		players[i].nr = (uint8_t)i;
+		players[i].bit = (uint8_t)(1 << i);
+		players[i].bombType = (uint8_t)(FTYPE_BOMB_P1 + (i & 1));
+	}
+	/* four player matches with a multitap in the second controller port */
+	detectMPlay5();
+#if defined(USE_REPLAY) || defined(REC_REPLAY)
+	playerCount = 2;
+#else /* not USE_REPLAY and not REC_REPLAY */
+	playerCount = snes_mplay5 ? MAX_PLAYERS : 2;
+#endif /* not USE_REPLAY and not REC_REPLAY */
+
 	/* load initial maps into VRAM */
 	dmaFillVramWord(0x0401, WORD_OFFSET(MAP_VRAM_BG), MAP_PAGE_SIZE); /* first page */
 	dmaCopyVram(bg1Map, WORD_OFFSET(MAP_VRAM_BG + MAP_PAGE_SIZE), MAP_PAGE_SIZE); /* second page */
@@ -2192,14 +3935,21 @@ int main(void) {
 	setMode(BG_MODE1, BG3_MODE1_PRORITY_HIGH);
 	bgSetDisable(2);
 	bgSetDisable(3);
+	/* show the profiler raster bars (debug builds only) */
+	PROFILE_INIT();
+	/* start with the estimated idle task slice times */
+	for (i = 0; i < ARRAY_SIZE(idleTasks); ++i) {
+		idlePeak[i] = idleTasks[i].lines;
+	}
+	memset(&frameStats, 0, sizeof(frameStats));
 
 	/* enable screen */
 	setScreenOn();
-	/* start BGM with little volume */
-#ifdef HAS_BGM
-	spcSetModuleVolume(BGM_NORMAL_VOL);
-	spcPlay(0);
-#endif /* HAS_BGM */
+
+#ifdef BENCH
+	/* run the benchmark scenarios instead of the game */
+	runBenchmark();
+#endif /* BENCH */
 
 	/* show title screen */
 	screen = S_TITLE;
@@ -2209,12 +3959,21 @@ int main(void) {
 	dropRate = DEF_DROP_RATE;
 	maxBombs = DEF_MAX_BOMBS;
 	maxRange = DEF_MAX_RANGE;
+	humanPlayers = playerCount; /* no CPU players */
+#ifdef USE_REPLAY
+	replayEntry = (const tReplayEntry *)replayData;
+	replayCount = 0;
+#endif /* USE_REPLAY */
 	for (;;) {
-		/* scanPads() gets called in consoleVblank() which is registered as NMI handler */
-		pad0 = padsCurrent(0);
-		pad1 = padsCurrent(1);
+		readPads();
 		ASSERT_ARY_IDX(screenHandler, screen);
 		screenHandler[screen]();
+#if defined(HAS_BGM) || defined(HAS_SFX)
+		bootAudioStep();
+#endif /* HAS_BGM or HAS_SFX */
+#ifdef HAS_SFX
+		updateSfx();
+#endif /* HAS_SFX */
 		WaitForVBlank();
 	}
 	return 0;
@@ -2,22 +2,158 @@
 ; @author Daniel Starke
 ; @copyright Copyright 2023 Daniel Starke
 ; @date 2023-07-07
-; @version 2023-07-15
+; @version 2026-10-14
 
+.equ REG_OAMADDL  $2102
 .equ REG_VMAIN    $2115
 .equ REG_VMADDL   $2116
 .equ REG_VMDATAL  $2118
 .equ REG_VMDATAH  $2119
+.equ REG_WMDATA   $2180
+.equ REG_WMADDL   $2181
+.equ REG_WMADDH   $2183
 .equ REG_MDMAEN   $420B
+.equ REG_HDMAEN   $420C
+.equ REG_MEMSEL   $420D
 .equ REG_DMAP0    $4300
 .equ REG_BBAD0    $4301
 .equ REG_A1T0L    $4302
 .equ REG_A1B0     $4304
 .equ REG_DAS0L    $4305
+.equ REG_DMAP1    $4310
+.equ REG_A1T1L    $4312
+.equ REG_A1B1     $4314
+.equ REG_DAS1L    $4315
+.equ REG_DMAP7    $4370
+.equ REG_BBAD7    $4371
+.equ REG_A1T7L    $4372
+.equ REG_A1B7     $4374
+.equ REG_SLHV     $2137
+.equ REG_OPVCT    $213D
+.equ REG_STAT78   $213F
+.equ REG_JOYWR    $4016
+.equ REG_JOYA     $4016
+.equ REG_JOYB     $4017
+.equ REG_HVBJOY   $4212
+
+.equ VRAM_QUEUE_SIZE 32 ; needs to match with utility.h
+.ifdef USE_LARGE_ARENA
+.equ CELL_COUNT     256 ; needs to match with utility.h
+.else
+.equ CELL_COUNT     224 ; needs to match with utility.h
+.endif ; USE_LARGE_ARENA
+.equ CELL_LIST_SIZE 160 ; needs to match with utility.h
+.equ LRNG_POOL_SIZE 128 ; needs to match with utility.h
+.equ SPRITE_COUNT   128 ; needs to match with utility.h
+.equ LZ_WINDOW      2048 ; needs to match with scripts/lz-compress.py
+.equ LZ_MAX_TOKEN   130 ; longest token output; needs to match with scripts/lz-compress.py
+.equ LZ_STAGE_SIZE  8192
+
+; game field element types and flags (needs to match with main.c)
+.equ FTYPE_EMPTY    0
+.equ FTYPE_BOMB_P1  1
+.equ FTYPE_BOMB_P2  2
+.equ FTYPE_PU_BOMB  3
+.equ FTYPE_PU_RANGE 4
+.equ FTYPE_PU_SPEED 5
+.equ FTYPE_SOLID    6
+.equ FTYPE_BRICKED  7
+.equ FTYPE_FLAME    8
+.equ CELL_TYPE      $0F
+.equ CELL_STOP      $10
+.equ CELL_DIRTY     $20
+.equ CELL_TOUCH     $40
+.equ CELL_BLOCKED   $80
+.equ SHAPE_MID      0
+.equ SHAPE_PART_X   1
+.equ SHAPE_END_X    2
+.equ SHAPE_PART_Y   3
+.equ SHAPE_END_Y    4
+.equ GFX_FLIP_X     $40
+.equ GFX_FLIP_Y     $80
+.equ INVALID_BOMB   255
+.equ EXPLOSION_ANIMATION 1
+.equ FIELD_ATTR     $2C ; TILE_ATTR(0, 0, 1, 3) of the game field tiles in main.c
 
 .RAMSECTION ".reg_utility7e" BANK $7E
 ; extern uint32_t lrngSeed;
 lrngSeed:         DSW 2 ; random seed
+; extern uint16_t lrngPool[LRNG_POOL_SIZE];
+lrngPool:         DSW LRNG_POOL_SIZE ; pre-generated random numbers
+; extern uint8_t lrngPoolHead;
+lrngPoolHead:     DB ; index of the next lrngPool entry (wraps)
+; extern uint8_t lrngPoolCount;
+lrngPoolCount:    DB ; number of valid lrngPool entries
+; extern uint16_t padLatch[2];
+padLatch:         DSW 2 ; manually read pad 1 and pad 2 values (see padsLatch())
+; extern uint8_t vramQueueCount;
+vramQueueCount:   DSB 1 ; number of queued VRAM transfers
+vramQueueSrc:     DSW VRAM_QUEUE_SIZE ; source address
+vramQueueBank:    DSW VRAM_QUEUE_SIZE ; source bank (low byte) and REG_VMAIN value (high byte)
+vramQueueMode:    DSW VRAM_QUEUE_SIZE ; REG_DMAP0 (low byte) and REG_BBAD0 value (high byte)
+vramQueueAddr:    DSW VRAM_QUEUE_SIZE ; VRAM destination address (word addressed)
+vramQueueSize:    DSW VRAM_QUEUE_SIZE ; number of bytes to be written
+splitScroll:      DSB 7 ; HDMA table of setSplitScroll() (upper lines, upper offset, 1 line, lower offset, end)
+.ends
+
+.RAMSECTION ".reg_sprites7e" BANK $7E
+; extern uint8_t spriteTable[SPRITE_COUNT * 4];
+spriteTable:      DSB (SPRITE_COUNT * 4) ; OAM low table shadow (x, y, tile, attributes)
+; extern uint8_t spriteHigh[SPRITE_COUNT / 4];
+spriteHigh:       DSB (SPRITE_COUNT / 4) ; OAM high table shadow (x bit 8 and size of 4 sprites per byte)
+; extern uint8_t spriteFirst, spriteEnd, spriteHighFirst, spriteHighEnd;
+spriteFirst:      DB ; first changed sprite
+spriteEnd:        DB ; sprite after the last changed sprite
+spriteHighFirst:  DB ; first changed spriteHigh byte
+spriteHighEnd:    DB ; spriteHigh byte after the last changed byte
+.ends
+
+.RAMSECTION ".reg_cells7e" BANK $7E
+; extern uint8_t cellMap[CELL_COUNT]; ...
+cellMap:          DSB CELL_COUNT ; type and flags of each game field element
+cellGfx:          DSB CELL_COUNT ; graphic variant of each game field element
+aniCell:          DSB CELL_COUNT ; remaining animation frames of each game field element
+ttlCell:          DSB CELL_COUNT ; animation frame time to live of each game field element
+bombMap:          DSB CELL_COUNT ; bomb pool index of each game field element
+aniList:          DSB CELL_LIST_SIZE ; animated game field elements
+aniListCount:     DSB 1
+dirtyCells:       DSB CELL_LIST_SIZE ; changed game field elements
+dirtyCellCount:   DSB 1
+rayLeft:          DSB CELL_COUNT ; steps to the nearest explosion stopping cell to the left
+rayRight:         DSB CELL_COUNT ; steps to the nearest explosion stopping cell to the right
+rayUp:            DSB CELL_COUNT ; steps to the nearest explosion stopping cell above
+rayDown:          DSB CELL_COUNT ; steps to the nearest explosion stopping cell below
+explosionBombs:   DSB 4 ; bomb pool indices hit by the last explodeCells() call
+explosionBombCount: DSB 1
+.ends
+
+.RAMSECTION ".reg_lz7f" BANK $7F
+lzStage:          DSB LZ_STAGE_SIZE ; decompression staging buffer for lzCopyVram()
+.ends
+
+; hot variables of main.c in the direct page (D = $0000) for short addressing from assembler
+; (fixed address in the upper part of the direct page, clear of the tcc__ registers at its start)
+.RAMSECTION ".reg_utility00" BANK 0 SLOT 1 ORGA $00E0 FORCE
+; extern uint8_t i, j, j2;
+i:                DSB 1 ; 8-bit loop variables
+j:                DSB 1
+j2:               DSB 1
+; extern uint16_t k, m;
+k:                DSW 1 ; 16-bit loop variables
+m:                DSW 1
+; extern int8_t dx, dy, ds;
+dx:               DSB 1 ; player movement
+dy:               DSB 1
+ds:               DSB 1
+; extern uint8_t x, y, x1, y1, x2, y2;
+x:                DSB 1 ; player collision detection
+y:                DSB 1
+x1:               DSB 1
+y1:               DSB 1
+x2:               DSB 1
+y2:               DSB 1
+; extern uint8_t * tiles;
+tiles:            DSW 2 ; current renderTiles entry (needs to be the last entry)
 .ends
 
 .include "hdr.asm"
@@ -26,6 +162,14 @@ lrngSeed:         DSW 2 ; random seed
 .16bit
 
 
+.section ".hotDirectPage_check" superfree
+; Fails to link with an out of 8-bit range error if the hot variables above
+; outgrow the reservation from $00E0 (i.e. the last byte is after $00FF).
+hotDirectPageCheck:
+	.db tiles + 3
+.ends
+
+
 .section ".dmaFillVramWord_text" superfree
 ; void dmaFillVramWord(const uint16_t value, const uint16_t address, const uint16_t size);
 dmaFillVramWord:
@@ -149,6 +293,1110 @@ dmaCopyVramHighBytes:
 .ends
 
 
+.section ".dmaCopyVramCells_text" superfree
+; void dmaCopyVramCells(const uint8_t * source, const uint16_t address, const uint16_t * cells, const uint16_t count);
+dmaCopyVramCells:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 15 | 2 byte count
+	                   ; 11 | 4 byte cells
+	                   ;  9 | 2 byte address
+	                   ;  5 | 4 byte source
+	                   ;  1 | 4 byte return address
+	                   ;  0 | 1 byte processor flags
+
+	rep #$30           ; 16-bit accumulator and index registers
+	lda 5,s
+	sta.l REG_A1T0L    ; source address (advanced by each transfer)
+	lda #$1801
+	sta.l REG_DMAP0    ; byte increment source, operate on REG_VMDATAL and REG_VMDATAH
+
+	sep #$20           ; 8-bit accumulator
+	lda 7,s
+	sta.l REG_A1B0     ; bank address of the source
+	lda #$80
+	sta.l REG_VMAIN    ; increment VRAM address every high byte
+
+	rep #$20           ; 16-bit accumulator
+	lda 11,s
+	sta.b tcc__r0      ; cell list address
+	lda 13,s
+	sta.b tcc__r0h     ; cell list bank
+	lda 15,s
+	asl A              ; two bytes per cell list entry
+	sta.b tcc__r1      ; end offset within the cell list
+	ldy #0             ; current offset within the cell list
+
+_dmaCopyVramCellsLoop:
+	cpy.b tcc__r1
+	bcs _dmaCopyVramCellsEnd
+	lda [tcc__r0],y    ; upper left tile offset of the cell
+	clc
+	adc 9,s
+	tax                ; copy accumulator to x register
+	; upper row
+	sta.l REG_VMADDL   ; VRAM destination address (word addressed)
+	lda #4
+	sta.l REG_DAS0L    ; two tile words per row
+	sep #$20           ; 8-bit accumulator
+	lda #1             ; turn on bit 1 (channel 0) of DMA
+	sta.l REG_MDMAEN
+	; lower row
+	rep #$20           ; 16-bit accumulator
+	txa                ; copy x register to accumulator
+	clc
+	adc #32            ; next row
+	sta.l REG_VMADDL   ; VRAM destination address (word addressed)
+	lda #4
+	sta.l REG_DAS0L    ; two tile words per row
+	sep #$20           ; 8-bit accumulator
+	lda #1             ; turn on bit 1 (channel 0) of DMA
+	sta.l REG_MDMAEN
+	rep #$20           ; 16-bit accumulator
+	iny                ; next cell list entry
+	iny
+	bra _dmaCopyVramCellsLoop
+
+_dmaCopyVramCellsEnd:
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+
+
+.section ".dmaCopyWram_text" superfree
+; void dmaCopyWram(const uint8_t * source, uint8_t * address, const uint16_t size);
+dmaCopyWram:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 13 | 2 byte size
+	                   ;  9 | 4 byte address
+	                   ;  5 | 4 byte source
+	                   ;  1 | 4 byte return address
+	                   ;  0 | 1 byte processor flags
+
+	rep #$20           ; 16-bit accumulator
+	lda 13,s
+	beq _dmaCopyWramEnd ; ignore empty transfers (zero means 64k bytes for DMA)
+	sta.l REG_DAS1L    ; number of bytes to be written
+	lda 5,s
+	sta.l REG_A1T1L    ; source address
+	lda 9,s
+	sta.l REG_WMADDL   ; WRAM destination address (low and middle byte)
+	lda #$8000
+	sta.l REG_DMAP1    ; byte increment source, operate on REG_WMDATA
+
+	sep #$20           ; 8-bit accumulator
+	lda 7,s
+	sta.l REG_A1B1     ; bank address of the source
+	lda 11,s
+	and #$01           ; bank $7E or $7F
+	sta.l REG_WMADDH   ; WRAM destination address (high bit)
+	lda #2             ; turn on bit 2 (channel 1) of DMA
+	sta.l REG_MDMAEN
+
+_dmaCopyWramEnd:
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+
+
+.section ".dmaFillWram_text" superfree
+; void dmaFillWram(const uint8_t * source, uint8_t * address, const uint16_t size);
+dmaFillWram:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 13 | 2 byte size
+	                   ;  9 | 4 byte address
+	                   ;  5 | 4 byte source
+	                   ;  1 | 4 byte return address
+	                   ;  0 | 1 byte processor flags
+
+	rep #$20           ; 16-bit accumulator
+	lda 13,s
+	beq _dmaFillWramEnd ; ignore empty transfers (zero means 64k bytes for DMA)
+	sta.l REG_DAS1L    ; number of bytes to be written
+	lda 5,s
+	sta.l REG_A1T1L    ; source address
+	lda 9,s
+	sta.l REG_WMADDL   ; WRAM destination address (low and middle byte)
+	lda #$8008
+	sta.l REG_DMAP1    ; fixed source address, operate on REG_WMDATA
+
+	sep #$20           ; 8-bit accumulator
+	lda 7,s
+	sta.l REG_A1B1     ; bank address of the source
+	lda 11,s
+	and #$01           ; bank $7E or $7F
+	sta.l REG_WMADDH   ; WRAM destination address (high bit)
+	lda #2             ; turn on bit 2 (channel 1) of DMA
+	sta.l REG_MDMAEN
+
+_dmaFillWramEnd:
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+
+
+.section ".copyWram_text" superfree
+; void copyWram(const uint8_t * source, uint8_t * address, const uint16_t size);
+copyWram:
+	php                ; push processor flags to stack (1 byte)
+	phb                ; push data bank to stack (1 byte)
+	                   ; stack:
+	                   ; 14 | 2 byte size
+	                   ; 10 | 4 byte address
+	                   ;  6 | 4 byte source
+	                   ;  2 | 4 byte return address
+	                   ;  1 | 1 byte processor flags
+	                   ;  0 | 1 byte data bank
+
+	rep #$30           ; 16-bit accumulator and index registers
+	lda 14,s
+	beq _copyWramEnd   ; ignore empty moves (zero means 64k bytes for MVN)
+	dec a              ; MVN moves a + 1 bytes
+	ldx 6,s            ; source address within bank $7E
+	ldy 10,s           ; destination address within bank $7E
+	mvn $7E,$7E        ; block move (sets the data bank to $7E)
+
+_copyWramEnd:
+	plb                ; pull data bank from stack (1 byte)
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+
+
+.section ".lzCopy_text" superfree
+; void lzCopyVram(const uint8_t * source, const uint16_t address);
+lzCopyVram:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 9 | 2 byte address
+	                   ; 5 | 4 byte source
+	                   ; 1 | 4 byte return address
+	                   ; 0 | 1 byte processor flags
+
+	rep #$30           ; 16-bit accumulator and index registers
+	lda 9,s
+	sta.b tcc__r3      ; VRAM destination address (word addressed)
+	ldx #(lzStage & $FFFF)
+	stx.b tcc__r2h     ; start of the data not yet transferred
+	lda #(lzStage + LZ_STAGE_SIZE - LZ_MAX_TOKEN) & $FFFF
+	sta.b tcc__r2      ; transfer before exceeding the staging buffer
+	jsr _lzDecompress
+	jsr _lzTransfer    ; remaining data
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; void lzCopyWram(const uint8_t * source, uint8_t * address);
+lzCopyWram:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 9 | 4 byte address
+	                   ; 5 | 4 byte source
+	                   ; 1 | 4 byte return address
+	                   ; 0 | 1 byte processor flags
+
+	rep #$30           ; 16-bit accumulator and index registers
+	ldx 9,s            ; destination address within bank $7F
+	lda #$FFFF
+	sta.b tcc__r2      ; no intermediate transfers
+	jsr _lzDecompress
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; Decompresses the source given on stack to bank $7F starting at x. Calls
+; _lzTransfer whenever x reaches tcc__r2 at the start of a token.
+; Requires 16-bit registers.
+_lzDecompress:
+	                   ; stack:
+	                   ; 7 | 4 byte source
+	                   ; 3 | 4 byte return address
+	                   ; 2 | 1 byte processor flags
+	                   ; 0 | 2 byte return address
+	                   ; direct page:
+	                   ; tcc__r0  | source address
+	                   ; tcc__r0h | source bank
+	                   ; tcc__r1  | remaining bytes
+	                   ; tcc__r1h | remaining bytes of the current token
+	                   ; tcc__r2  | transfer threshold
+	                   ; tcc__r2h | start of the data not yet transferred
+	                   ; tcc__r3  | VRAM destination address (lzCopyVram only)
+	lda 7,s
+	sta.b tcc__r0      ; source address
+	lda 9,s
+	sta.b tcc__r0h     ; source bank
+	phb                ; push data bank to stack (1 byte)
+	sep #$20           ; 8-bit accumulator
+	lda #$7F
+	pha                ; push accumulator to stack
+	plb                ; set data bank to $7F
+	rep #$20           ; 16-bit accumulator
+	lda [tcc__r0]      ; uncompressed size
+	sta.b tcc__r1
+	ldy #2             ; first token
+_lzDecompressToken:
+	lda.b tcc__r1
+	beq _lzDecompressEnd
+	cpx.b tcc__r2
+	bcc _lzDecompressRead
+	jsr _lzTransfer
+	jsr _lzRewind
+_lzDecompressRead:
+	lda [tcc__r0],y
+	iny
+	and #$00FF         ; token byte
+	bit #$0080
+	bne _lzDecompressMatch
+	; literal bytes
+	inc A              ; 1..128 bytes
+	jsr _lzCount
+	sep #$20           ; 8-bit accumulator
+_lzDecompressLiteral:
+	lda [tcc__r0],y
+	iny
+	sta.w $0000,x
+	inx
+	dec.b tcc__r1h
+	bne _lzDecompressLiteral
+	rep #$20           ; 16-bit accumulator
+	bra _lzDecompressToken
+_lzDecompressMatch:
+	; copy from previous output (may overlap)
+	and #$007F
+	clc
+	adc #3             ; 3..130 bytes
+	jsr _lzCount
+	lda [tcc__r0],y    ; distance
+	iny
+	iny
+	phy                ; push source index to stack
+	eor #$FFFF
+	inc A              ; negative distance
+	phx                ; push destination address to stack
+	clc
+	adc 1,s
+	tay                ; copy accumulator to y register
+	plx                ; pull destination address from stack
+	sep #$20           ; 8-bit accumulator
+_lzDecompressCopy:
+	lda.w $0000,y
+	iny
+	sta.w $0000,x
+	inx
+	dec.b tcc__r1h
+	bne _lzDecompressCopy
+	rep #$20           ; 16-bit accumulator
+	ply                ; pull source index from stack
+	bra _lzDecompressToken
+_lzDecompressEnd:
+	plb                ; pull data bank from stack (1 byte)
+	rts                ; return from subroutine
+
+; Sets the token length to a and removes it from the remaining bytes.
+_lzCount:
+	sta.b tcc__r1h
+	lda.b tcc__r1
+	sec
+	sbc.b tcc__r1h
+	sta.b tcc__r1
+	rts
+
+; Transfers the staged words from tcc__r2h up to x to the VRAM address
+; tcc__r3 via DMA channel 1 and advances tcc__r2h and tcc__r3. An odd byte
+; is left for the next transfer. All registers are set for each transfer as
+; the VBlank handler may use the VRAM port in between. Requires 16-bit
+; registers.
+_lzTransfer:
+	txa                ; copy x register to accumulator
+	sec
+	sbc.b tcc__r2h
+	and #$FFFE         ; whole words only
+	beq _lzTransferEnd ; nothing staged
+	sta.l REG_DAS1L    ; number of bytes to be written
+	pha                ; push byte count to stack
+	lda.b tcc__r2h
+	sta.l REG_A1T1L    ; source address
+	clc
+	adc 1,s
+	sta.b tcc__r2h     ; start of the data not yet transferred
+	lda.b tcc__r3
+	sta.l REG_VMADDL   ; VRAM destination address (word addressed)
+	pla                ; pull byte count from stack
+	lsr A              ; word count
+	clc
+	adc.b tcc__r3
+	sta.b tcc__r3      ; VRAM address of the next transfer
+	lda #$1801
+	sta.l REG_DMAP1    ; byte increment source, operate on REG_VMDATAL and REG_VMDATAH
+	sep #$20           ; 8-bit accumulator
+	lda #:lzStage
+	sta.l REG_A1B1     ; bank address of the source
+	lda #$80
+	sta.l REG_VMAIN    ; increment VRAM address every high byte
+	lda #2             ; turn on bit 2 (channel 1) of DMA
+	sta.l REG_MDMAEN
+	rep #$20           ; 16-bit accumulator
+_lzTransferEnd:
+	rts
+
+; Moves the last LZ_WINDOW bytes before x to the start of the staging buffer
+; for the following matches and continues behind them. Requires 16-bit
+; registers and the data bank $7F.
+_lzRewind:
+	phy                ; push source index to stack
+	txa                ; copy x register to accumulator
+	sec
+	sbc.b tcc__r2h
+	pha                ; push number of bytes not yet transferred (0 or 1) to stack
+	txa                ; copy x register to accumulator
+	sec
+	sbc #LZ_WINDOW
+	tax                ; source of the block move
+	ldy #(lzStage & $FFFF)
+	lda #(LZ_WINDOW - 1)
+	mvn $7F,$7F        ; move within bank $7F
+	tyx                ; continue behind the moved bytes
+	txa                ; copy x register to accumulator
+	sec
+	sbc 1,s
+	sta.b tcc__r2h     ; start of the data not yet transferred
+	pla                ; pull number of bytes not yet transferred from stack
+	ply                ; pull source index from stack
+	rts
+
+.ends
+
+
+.section ".vramQueueAdd_text" superfree
+; void vramQueueAdd(const uint8_t * source, const uint16_t address, const uint16_t size, const uint16_t mode);
+vramQueueAdd:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 13 | 2 byte mode
+	                   ; 11 | 2 byte size
+	                   ;  9 | 2 byte address
+	                   ;  5 | 4 byte source
+	                   ;  1 | 4 byte return address
+	                   ;  0 | 1 byte processor flags
+
+	rep #$30           ; 16-bit accumulator and index registers
+	lda 11,s
+	beq _vramQueueAddEnd ; ignore empty transfers (zero means 64k bytes for DMA)
+	lda.l vramQueueCount
+	and #$00FF
+	cmp #VRAM_QUEUE_SIZE
+.ifndef NDEBUG
+	bcc _vramQueueAddFree
+	lda #_vramQueueFullMsg ; break with a message like ASSERT() does
+	sta.l debugMessage
+	lda #:_vramQueueFullMsg
+	sta.l debugMessage + 2
+	jsl debugBreak
+	bra _vramQueueAddEnd ; drop the transfer after the break
+_vramQueueAddFree:
+.else
+	bcs _vramQueueAddEnd ; ignore transfer if the queue is full
+.endif ; NDEBUG
+	asl A              ; two bytes per queue entry field
+	tax                ; copy accumulator to x register
+	lda 5,s
+	sta.l vramQueueSrc,x
+	lda 9,s
+	sta.l vramQueueAddr,x
+	lda 11,s
+	sta.l vramQueueSize,x
+	lda 13,s
+	sta.l vramQueueMode,x
+
+	cmp #$1800         ; VRAM_LOW?
+	bne _vramQueueAddHigh
+	sep #$20           ; 8-bit accumulator
+	lda #$00           ; increment VRAM address every low byte
+	bra _vramQueueAddBank
+_vramQueueAddHigh:
+	sep #$20           ; 8-bit accumulator
+	lda #$80           ; increment VRAM address every high byte
+_vramQueueAddBank:
+	sta.l vramQueueBank + 1,x
+	lda 7,s
+	sta.l vramQueueBank,x ; bank address of the source
+	lda.l vramQueueCount
+	inc A
+	sta.l vramQueueCount
+
+_vramQueueAddEnd:
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ifndef NDEBUG
+_vramQueueFullMsg:
+	.db "utility.asm:vramQueueAdd:queue full", 0
+.endif ; NDEBUG
+
+.ends
+
+
+.section ".vramQueueFlush_text" superfree
+; void vramQueueFlush(void);
+vramQueueFlush:
+	php                ; push processor flags to stack (1 byte)
+	rep #$30           ; 16-bit accumulator and index registers
+	lda.l vramQueueCount
+	and #$00FF
+	asl A              ; two bytes per queue entry field
+	sta.b tcc__r0      ; end offset within the queue
+	ldx #0             ; current offset within the queue
+
+_vramQueueFlushLoop:
+	cpx.b tcc__r0
+	bcs _vramQueueFlushEnd
+	lda.l vramQueueMode,x
+	sta.l REG_DMAP0    ; transfer mode and destination register
+	lda.l vramQueueSrc,x
+	sta.l REG_A1T0L    ; source address
+	lda.l vramQueueAddr,x
+	sta.l REG_VMADDL   ; VRAM destination address (word addressed)
+	lda.l vramQueueSize,x
+	sta.l REG_DAS0L    ; number of bytes to be written
+
+	sep #$20           ; 8-bit accumulator
+	lda.l vramQueueBank,x
+	sta.l REG_A1B0     ; bank address of the source
+	lda.l vramQueueBank + 1,x
+	sta.l REG_VMAIN    ; VRAM address increment mode
+	lda #1             ; turn on bit 1 (channel 0) of DMA
+	sta.l REG_MDMAEN
+
+	rep #$20           ; 16-bit accumulator
+	inx                ; next queue entry
+	inx
+	bra _vramQueueFlushLoop
+
+_vramQueueFlushEnd:
+	sep #$20           ; 8-bit accumulator
+	lda #0
+	sta.l vramQueueCount ; queue is empty now
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+
+
+.section ".spriteFlush_text" superfree
+; void spriteFlush(void);
+spriteFlush:
+	php                ; push processor flags to stack (1 byte)
+	sep #$20           ; 8-bit accumulator
+	rep #$10           ; 16-bit index registers
+	lda #:spriteTable
+	sta.l REG_A1B0     ; source bank
+	lda #$04
+	sta.l REG_BBAD0    ; destination REG_OAMDATA
+	lda #$00
+	sta.l REG_DMAP0    ; CPU to PPU, increment source address, 1 register write once
+	; changed low table range
+	lda.w spriteFirst
+	cmp.w spriteEnd
+	bcs _spriteFlushHigh ; low table unchanged
+	rep #$20           ; 16-bit accumulator
+	and #$00FF
+	asl A              ; two words per sprite
+	sta.l REG_OAMADDL  ; word address in the low table
+	asl A              ; four bytes per sprite
+	tax                ; copy accumulator to x register
+	clc
+	adc #spriteTable
+	sta.l REG_A1T0L    ; source address
+	stx.b tcc__r0      ; byte offset of the first changed sprite
+	lda.w spriteEnd
+	and #$00FF
+	asl A
+	asl A
+	sec
+	sbc.b tcc__r0
+	sta.l REG_DAS0L    ; number of bytes
+	sep #$20           ; 8-bit accumulator
+	lda #1             ; turn on bit 1 (channel 0) of DMA
+	sta.l REG_MDMAEN
+	lda #SPRITE_COUNT
+	sta.w spriteFirst
+	stz.w spriteEnd
+_spriteFlushHigh:
+	; changed high table range
+	lda.w spriteHighFirst
+	cmp.w spriteHighEnd
+	bcs _spriteFlushEnd ; high table unchanged
+	rep #$20           ; 16-bit accumulator
+	and #$00FE         ; start at a word boundary
+	tax                ; copy accumulator to x register
+	lsr A              ; word address
+	ora #$0100         ; select the high table
+	sta.l REG_OAMADDL
+	txa                ; copy x register to accumulator
+	clc
+	adc #spriteHigh
+	sta.l REG_A1T0L    ; source address
+	stx.b tcc__r0      ; byte offset of the first changed byte
+	lda.w spriteHighEnd
+	and #$00FF
+	sec
+	sbc.b tcc__r0
+	sta.l REG_DAS0L    ; number of bytes
+	sep #$20           ; 8-bit accumulator
+	lda #1             ; turn on bit 1 (channel 0) of DMA
+	sta.l REG_MDMAEN
+	lda #(SPRITE_COUNT / 4)
+	sta.w spriteHighFirst
+	stz.w spriteHighEnd
+_spriteFlushEnd:
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+
+
+.section ".explodeCells_text" superfree
+; void updateRays(const uint16_t cell);
+updateRays:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 5 | 2 byte cell
+	                   ; 1 | 4 byte return address
+	                   ; 0 | 1 byte processor flags
+
+	sep #$30           ; 8-bit accumulator and index registers
+	lda 5,s
+	tax                ; copy accumulator to x register
+	jsr _updateRays
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; Updates the ray lengths of the cells which see cell x as nearest explosion
+; stopping cell (or did so before). Each direction ends with the next
+; stopping cell which is updated as well. Keeps x. Requires 8-bit registers.
+_updateRays:
+	phx                ; push changed cell to stack
+	; left ray of the cells to the right
+_updateRaysLeft:
+	inx
+	lda.w cellMap-1,x
+	and #CELL_STOP
+	beq _updateRaysLeftAdd
+	lda #1             ; stopped by the previous cell
+	bra _updateRaysLeftSet
+_updateRaysLeftAdd:
+	lda.w rayLeft-1,x
+	inc A
+_updateRaysLeftSet:
+	sta.w rayLeft,x
+	lda.w cellMap,x
+	and #CELL_STOP
+	beq _updateRaysLeft ; until the next stopping cell
+	lda 1,s
+	tax                ; restore changed cell
+	; right ray of the cells to the left
+_updateRaysRight:
+	dex
+	lda.w cellMap+1,x
+	and #CELL_STOP
+	beq _updateRaysRightAdd
+	lda #1             ; stopped by the next cell
+	bra _updateRaysRightSet
+_updateRaysRightAdd:
+	lda.w rayRight+1,x
+	inc A
+_updateRaysRightSet:
+	sta.w rayRight,x
+	lda.w cellMap,x
+	and #CELL_STOP
+	beq _updateRaysRight ; until the next stopping cell
+	lda 1,s
+	tax                ; restore changed cell
+	; up ray of the cells below
+_updateRaysUp:
+	txa
+	clc
+	adc #16            ; next row
+	tax
+	lda.w cellMap-16,x
+	and #CELL_STOP
+	beq _updateRaysUpAdd
+	lda #1             ; stopped by the cell above
+	bra _updateRaysUpSet
+_updateRaysUpAdd:
+	lda.w rayUp-16,x
+	inc A
+_updateRaysUpSet:
+	sta.w rayUp,x
+	lda.w cellMap,x
+	and #CELL_STOP
+	beq _updateRaysUp  ; until the next stopping cell
+	lda 1,s
+	tax                ; restore changed cell
+	; down ray of the cells above
+_updateRaysDown:
+	txa
+	sec
+	sbc #16            ; previous row
+	tax
+	lda.w cellMap+16,x
+	and #CELL_STOP
+	beq _updateRaysDownAdd
+	lda #1             ; stopped by the cell below
+	bra _updateRaysDownSet
+_updateRaysDownAdd:
+	lda.w rayDown+16,x
+	inc A
+_updateRaysDownSet:
+	sta.w rayDown,x
+	lda.w cellMap,x
+	and #CELL_STOP
+	beq _updateRaysDown ; until the next stopping cell
+	plx                ; pull changed cell from stack
+	rts
+
+.ifndef USE_C_EXPLOSION
+; void explodeCells(const uint16_t cell, const uint16_t range);
+explodeCells:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 7 | 2 byte range
+	                   ; 5 | 2 byte cell
+	                   ; 1 | 4 byte return address
+	                   ; 0 | 1 byte processor flags
+	                   ; direct page:
+	                   ; tcc__r0  | center cell
+	                   ; tcc__r0h | range
+	                   ; tcc__r1  | cell offset per step
+	                   ; tcc__r1h | remaining steps
+	                   ; tcc__r2  | explosion graphic flags
+	                   ; tcc__r2h | explosion part shape
+	                   ; tcc__r3  | current cell
+
+	sep #$30           ; 8-bit accumulator and index registers
+	lda 5,s
+	sta.b tcc__r0      ; center cell
+	lda 7,s
+	sta.b tcc__r0h     ; range
+	stz.w explosionBombCount
+
+	; center
+	ldx.b tcc__r0
+	jsr _explodeStartAnimation
+	ldy #(SHAPE_MID << 3)
+	jsr _explodeSetFlame
+	jsr _updateRays    ; the bomb no longer stops explosions
+	; going left
+	lda #$FF
+	sta.b tcc__r1      ; previous column
+	lda #GFX_FLIP_X
+	sta.b tcc__r2
+	lda #SHAPE_PART_X
+	sta.b tcc__r2h
+	ldx.b tcc__r0
+	lda.w rayLeft,x
+	jsr _explodeRay
+	; going right
+	lda #$01
+	sta.b tcc__r1      ; next column
+	stz.b tcc__r2
+	ldx.b tcc__r0
+	lda.w rayRight,x
+	jsr _explodeRay
+	; going up
+	lda #$F0
+	sta.b tcc__r1      ; previous row
+	lda #GFX_FLIP_Y
+	sta.b tcc__r2
+	lda #SHAPE_PART_Y
+	sta.b tcc__r2h
+	ldx.b tcc__r0
+	lda.w rayUp,x
+	jsr _explodeRay
+	; going down
+	lda #$10
+	sta.b tcc__r1      ; next row
+	stz.b tcc__r2
+	ldx.b tcc__r0
+	lda.w rayDown,x
+	jsr _explodeRay
+
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; Walks a single explosion ray of at most a steps. a is the distance to the
+; next explosion stopping cell (see updateRays()), so all cells before are
+; either empty or flames. The solid walls around the game field stop each
+; ray before leaving the cell arrays.
+_explodeRay:
+	cmp.b tcc__r0h
+	bcc _explodeRaySteps ; stopping cell within range
+	lda.b tcc__r0h
+	beq _explodeRayEnd ; zero range
+_explodeRaySteps:
+	sta.b tcc__r1h     ; remaining steps
+	lda.b tcc__r0
+	sta.b tcc__r3      ; current cell
+	bra _explodeRayLoop
+_explodeRayNext:
+	dec.b tcc__r1h
+	beq _explodeRayEnd ; range reached
+_explodeRayLoop:
+	lda.b tcc__r3
+	clc
+	adc.b tcc__r1
+	sta.b tcc__r3      ; next cell in ray direction
+	tax                ; copy accumulator to x register
+	lda.w cellMap,x
+	and #CELL_TYPE
+	asl A              ; two bytes per jump table entry
+	tax                ; copy accumulator to x register
+	jmp (_explodeRayTable,x)
+_explodeRayEnd:
+	rts                ; return from subroutine (ray blocked or range reached)
+
+_explodeRayTable:
+	.dw _explodeEmpty   ; FTYPE_EMPTY
+	.dw _explodeBomb    ; FTYPE_BOMB_P1
+	.dw _explodeBomb    ; FTYPE_BOMB_P2
+	.dw _explodePowerUp ; FTYPE_PU_BOMB
+	.dw _explodePowerUp ; FTYPE_PU_RANGE
+	.dw _explodePowerUp ; FTYPE_PU_SPEED
+	.dw _explodeRayEnd  ; FTYPE_SOLID
+	.dw _explodeBricked ; FTYPE_BRICKED
+	.dw _explodeFlame   ; FTYPE_FLAME
+
+_explodeEmpty:
+	ldx.b tcc__r3
+	jsr _explodeStartAnimation
+	lda.b tcc__r2h     ; explosion part
+	ldy.b tcc__r1h
+	dey
+	bne _explodeEmptyShape
+	inc A              ; explosion end follows explosion part on the last step
+_explodeEmptyShape:
+	asl A              ; shift shape to CELL_GFX position
+	asl A
+	asl A
+	ora.b tcc__r2      ; explosion graphic flags
+	tay                ; copy accumulator to y register
+	jsr _explodeSetFlame
+	jmp _explodeRayNext
+
+_explodeFlame:
+	; overlapping explosions
+	ldx.b tcc__r3
+	lda.w cellGfx,x
+	lsr A              ; shift CELL_GFX down to shape
+	lsr A
+	lsr A
+	and #$07           ; current explosion shape
+	ldy.b tcc__r2h
+	cpy #SHAPE_PART_X
+	bne _explodeFlameY
+	; horizontal explosion
+	cmp #SHAPE_PART_Y
+	bcs _explodeFlameCross ; crossing vertical explosion
+	cmp #SHAPE_END_X
+	bcs _explodeFlameExtend ; hits end of horizontal explosion
+	jmp _explodeRayNext
+_explodeFlameY:
+	; vertical explosion
+	cmp #SHAPE_PART_Y
+	bcc _explodeFlameCross ; crossing horizontal explosion
+	cmp #SHAPE_END_Y
+	bcs _explodeFlameExtend ; hits end of vertical explosion
+	jmp _explodeRayNext
+_explodeFlameCross:
+	jsr _explodeStartAnimation
+	ldy #(SHAPE_MID << 3)
+	jsr _explodeSetFlame
+	jmp _explodeRayNext
+_explodeFlameExtend:
+	jsr _explodeStartAnimation
+	lda.b tcc__r2h     ; explosion part
+	asl A              ; shift shape to CELL_GFX position
+	asl A
+	asl A
+	ora.b tcc__r2      ; explosion graphic flags
+	tay                ; copy accumulator to y register
+	jsr _explodeSetFlame
+	jmp _explodeRayNext
+
+_explodePowerUp:
+	; explosion ends here but destroys the power-up
+	ldx.b tcc__r3
+	lda #FTYPE_EMPTY
+	ldy #0
+	jsr _explodeSetCell
+	jsr _updateRays    ; the power-up no longer stops explosions
+	rts                ; return from subroutine (ray blocked)
+
+_explodeBomb:
+	; chain reaction (bombs already triggered are no longer in bombMap)
+	ldx.b tcc__r3
+	lda.w bombMap,x
+	cmp #INVALID_BOMB
+	beq _explodeBombEnd
+	ldy.w explosionBombCount
+	sta.w explosionBombs,y
+	iny
+	sty.w explosionBombCount
+_explodeBombEnd:
+	rts                ; return from subroutine (ray blocked)
+
+_explodeBricked:
+	ldx.b tcc__r3
+	lda.w aniCell,x
+	bne _explodeBrickedEnd ; already hit
+	jsr _explodeStartAnimation
+	lda #(FTYPE_BRICKED | CELL_BLOCKED | CELL_STOP)
+	ldy #1             ; first breaking wall animation frame
+	jsr _explodeSetCell
+_explodeBrickedEnd:
+	rts                ; return from subroutine (ray blocked)
+
+; Starts the animation of cell x. Keeps x.
+_explodeStartAnimation:
+	lda.w aniCell,x
+	bne _explodeStartAnimationSet
+	txa                ; copy x register to accumulator
+	ldy.w aniListCount
+	sta.w aniList,y    ; add to the active animation list
+	iny
+	sty.w aniListCount
+_explodeStartAnimationSet:
+	lda #4
+	sta.w aniCell,x
+	lda #EXPLOSION_ANIMATION
+	sta.w ttlCell,x
+	rts
+
+; Sets cell x to a flame with the graphic variant y. Keeps x.
+_explodeSetFlame:
+	lda #(FTYPE_FLAME | CELL_TOUCH)
+; Sets cell x to type and flags in a with the graphic variant y. Keeps x.
+_explodeSetCell:
+	pha                ; push new type and flags to stack
+	tya                ; copy y register to accumulator
+	sta.w cellGfx,x
+	lda.w cellMap,x
+	and #CELL_DIRTY
+	bne _explodeSetCellQueued
+	txa                ; copy x register to accumulator
+	ldy.w dirtyCellCount
+	sta.w dirtyCells,y ; queue for the render stage
+	iny
+	sty.w dirtyCellCount
+_explodeSetCellQueued:
+	pla                ; pull new type and flags from stack
+	ora #CELL_DIRTY
+	sta.w cellMap,x
+	rts
+
+.endif ; USE_C_EXPLOSION
+.ends
+
+
+.section ".renderCellTiles_text" superfree
+; void renderCellTiles(void);
+renderCellTiles:
+	php                ; push processor flags to stack (1 byte)
+	                   ; direct page:
+	                   ; j     | cell index
+	                   ; j2    | upper left tile index of the graphic variant
+	                   ; tiles | destination tile map words (upper row, then lower row)
+
+	sep #$30           ; 8-bit accumulator and index registers
+	ldx.b j
+	lda.w cellGfx,x
+	and #(GFX_FLIP_X | GFX_FLIP_Y)
+	ora #FIELD_ATTR    ; tile attribute (high bytes)
+	ldy #1
+	sta [tiles],y
+	ldy #3
+	sta [tiles],y
+	ldy #5
+	sta [tiles],y
+	ldy #7
+	sta [tiles],y
+
+	lda.w cellMap,x
+	and #CELL_TYPE
+	bne _renderCellTilesVariant
+	; FTYPE_EMPTY (accumulator equals FIELD_EMPTY)
+	sta [tiles]
+	ldy #2
+	sta [tiles],y
+	ldy #4
+	sta [tiles],y
+	ldy #6
+	sta [tiles],y
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+_renderCellTilesVariant:
+	; tile indices (low bytes) in upper/lower row order
+	lda.w cellGfx,x
+	bmi _renderCellTilesFlipY ; GFX_FLIP_Y
+	and #GFX_FLIP_X
+	bne _renderCellTilesFlipX
+	lda.b j2
+	sta [tiles]        ; j2 + $00
+	inc A
+	ldy #2
+	sta [tiles],y      ; j2 + $01
+	clc
+	adc #$0F
+	ldy #4
+	sta [tiles],y      ; j2 + $10
+	inc A
+	ldy #6
+	sta [tiles],y      ; j2 + $11
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+_renderCellTilesFlipX:
+	lda.b j2
+	ldy #2
+	sta [tiles],y      ; j2 + $00
+	inc A
+	sta [tiles]        ; j2 + $01
+	clc
+	adc #$0F
+	ldy #6
+	sta [tiles],y      ; j2 + $10
+	inc A
+	ldy #4
+	sta [tiles],y      ; j2 + $11
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+_renderCellTilesFlipY:
+	lda.b j2
+	ldy #4
+	sta [tiles],y      ; j2 + $00
+	inc A
+	ldy #6
+	sta [tiles],y      ; j2 + $01
+	clc
+	adc #$0F
+	sta [tiles]        ; j2 + $10
+	inc A
+	ldy #2
+	sta [tiles],y      ; j2 + $11
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+
+
+.section ".setSplitScroll_text" superfree
+; void setSplitScroll(const uint16_t lines, const uint16_t upper, const uint16_t lower);
+setSplitScroll:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 9 | 2 byte lower
+	                   ; 7 | 2 byte upper
+	                   ; 5 | 2 byte lines
+	                   ; 1 | 4 byte return address
+	                   ; 0 | 1 byte processor flags
+
+	rep #$20           ; 16-bit accumulator
+	lda 7,s
+	sta.w splitScroll+1 ; upper offset
+	lda 9,s
+	sta.w splitScroll+4 ; lower offset (kept until the end of the frame)
+	lda #splitScroll
+	sta.l REG_A1T7L
+	sep #$20           ; 8-bit accumulator
+	lda 5,s
+	sta.w splitScroll  ; number of upper lines
+	lda #1
+	sta.w splitScroll+3
+	stz.w splitScroll+6 ; end of table
+	lda #:splitScroll
+	sta.l REG_A1B7
+	lda #$02           ; write one register twice per entry
+	sta.l REG_DMAP7
+	lda #$0E           ; BG1VOFS
+	sta.l REG_BBAD7
+	lda #$80           ; enable HDMA channel 7 (read from the next frame on)
+	sta.l REG_HDMAEN
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+
+.ifdef USE_FASTROM
+.section ".fastRomInit_text" superfree
+; void fastRomInit(void);
+fastRomInit:
+	php                ; push processor flags to stack (1 byte)
+	sep #$20           ; 8-bit accumulator
+	lda #1
+	sta.l REG_MEMSEL   ; 3.58 MHz access for the ROM banks $80 and above
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+.endif ; USE_FASTROM
+
+
+.section ".getScanline_text" superfree
+; uint16_t getScanline(void);
+getScanline:
+	php                ; push processor flags to stack (1 byte)
+	sep #$20           ; 8-bit accumulator
+	lda.l REG_STAT78   ; reset the REG_OPVCT low/high byte selection
+	lda.l REG_SLHV     ; latch the H/V counters
+	lda.l REG_OPVCT    ; low byte
+	xba                ; exchange low and high byte of the accumulator
+	lda.l REG_OPVCT    ; high byte (only bit 0 is valid)
+	and #$01
+	xba                ; exchange low and high byte of the accumulator
+	rep #$20           ; 16-bit accumulator
+	sta.b tcc__r0      ; store accumulator in return register
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+
+
+.section ".padsLatch_text" superfree
+; void padsLatch(void);
+padsLatch:
+	php                ; push processor flags to stack (1 byte)
+	sep #$30           ; 8-bit accumulator and index registers
+_padsLatchWait:
+	lda.l REG_HVBJOY
+	lsr A              ; auto-joypad read busy flag to carry
+	bcs _padsLatchWait ; wait for the end of the auto-joypad read
+	lda #1
+	sta.l REG_JOYWR    ; latch the pad buttons
+	dec A
+	sta.l REG_JOYWR    ; start serial output
+	rep #$20           ; 16-bit accumulator
+	ldx #16            ; 16 bits per pad (B first; same order as the auto-joypad read)
+_padsLatchLoop:
+	lda.l REG_JOYA     ; pad 1 data bit in bit 0 and pad 2 data bit in bit 8 (REG_JOYB)
+	lsr A              ; pad 1 data bit to carry
+	rol.w padLatch     ; shift carry into the pad 1 value
+	xba                ; exchange low and high byte of the accumulator (pad 2 data bit to bit 15)
+	asl A              ; pad 2 data bit to carry
+	rol.w padLatch + 2 ; shift carry into the pad 2 value
+	dex
+	bne _padsLatchLoop
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+.ends
+
+
 .section ".lrng_text" superfree
 ; uint16_t lrng(void) {
 ; 	lrngSeed ^= lrngSeed >> 17;
@@ -158,6 +1406,52 @@ dmaCopyVramHighBytes:
 ; }
 lrng:
 	php                ; push processor flags to stack (1 byte)
+	jsr _lrngNext
+	sta.b tcc__r0      ; store accumulator in return register
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; void lrngFill(const uint16_t line);
+lrngFill:
+	php                ; push processor flags to stack (1 byte)
+	                   ; stack:
+	                   ; 5 | 2 byte line
+	                   ; 1 | 4 byte return address
+	                   ; 0 | 1 byte processor flags
+
+	sep #$30           ; 8-bit accumulator and index registers
+_lrngFillLoop:
+	lda.w lrngPoolCount
+	cmp #LRNG_POOL_SIZE
+	bcs _lrngFillEnd   ; pool is full
+	lda.l REG_STAT78   ; reset the REG_OPVCT low/high byte selection
+	lda.l REG_SLHV     ; latch the H/V counters
+	lda.l REG_OPVCT    ; low byte
+	xba                ; exchange low and high byte of the accumulator
+	lda.l REG_OPVCT    ; high byte (only bit 0 is valid)
+	and #$01
+	xba                ; exchange low and high byte of the accumulator
+	rep #$20           ; 16-bit accumulator
+	cmp 5,s
+	bcs _lrngFillEnd   ; given scanline reached
+	sep #$20           ; 8-bit accumulator
+	lda.w lrngPoolHead
+	clc
+	adc.w lrngPoolCount
+	and #(LRNG_POOL_SIZE - 1) ; first free entry
+	asl A              ; two bytes per entry
+	tax                ; copy accumulator to x register
+	jsr _lrngNext
+	sta.w lrngPool,x
+	sep #$20           ; 8-bit accumulator
+	inc.w lrngPoolCount
+	bra _lrngFillLoop
+_lrngFillEnd:
+	plp                ; pull processor flags from stack (1 byte)
+	rtl                ; return from subroutine long
+
+; Generates the next random number into the 16-bit accumulator. Keeps x.
+_lrngNext:
 	rep #$20           ; 16-bit accumulator
 	; lrngSeed ^= lrngSeed >> 17;
 	lda.w lrngSeed + 2 ; high word to accumulator
@@ -188,8 +1482,6 @@ lrng:
 	; return (uint16_t)lrngSeed;
 	rep #$20           ; 16-bit accumulator
 	lda.w lrngSeed     ; load low word to accumulator
-	sta.b tcc__r0      ; store accumulator in return register
-	plp                ; pull processor flags from stack (1 byte)
-	rtl                ; return from subroutine long
+	rts                ; return from subroutine
 
 .ends
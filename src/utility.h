@@ -3,7 +3,7 @@
 * @author Daniel Starke
 * @copyright Copyright 2023 Daniel Starke
 * @date 2023-07-09
-* @version 2023-07-15
+* @version 2026-10-14
 */
 #ifndef _UTILITY_H_
 #define _UTILITY_H_
@@ -11,8 +11,105 @@
 #include <stdint.h>
 
 
+/** Maximum number of entries in the VRAM transfer queue (see `vramQueueAdd()`). */
+#define VRAM_QUEUE_SIZE 32
+
+
+/**
+ * @def CELL_ROWS
+ * Number of game field cell rows with 16 cells each. The large arena uses all
+ * 16 rows of the 8-bit `cellMap` index and is being scrolled vertically.
+ */
+#ifdef USE_LARGE_ARENA
+#define CELL_ROWS 16
+#else /* not USE_LARGE_ARENA */
+#define CELL_ROWS 14
+#endif /* not USE_LARGE_ARENA */
+
+
+/** Number of entries in the game field cell arrays (e.g. `cellMap`; 16 cells per row). */
+#define CELL_COUNT (CELL_ROWS * 16)
+
+
+/** Number of entries in the game field cell lists (at least the number of changeable cells). */
+#define CELL_LIST_SIZE 160
+
+
+/** Mode for `vramQueueAdd()` to write the source bytes to the VRAM low bytes. */
+#define VRAM_LOW  0x1800
+/** Mode for `vramQueueAdd()` to write the source bytes to the VRAM high bytes. */
+#define VRAM_HIGH 0x1900
+/** Mode for `vramQueueAdd()` to write the source words to VRAM. */
+#define VRAM_WORD 0x1801
+
+
+/** Number of entries in the random number pool `lrngPool` (power of two <= 128). */
+#define LRNG_POOL_SIZE 128
+
+
+/** Number of hardware sprites (see `spriteTable`). */
+#define SPRITE_COUNT 128
+
+
 /** Random seed for `lrng()`. Shall not be zero! */
 extern uint32_t lrngSeed;
+/** Ring buffer of the next random numbers of `lrng()` (see `lrngFill()`). */
+extern uint16_t lrngPool[LRNG_POOL_SIZE];
+/** Index of the next `lrngPool` entry (wraps around). */
+extern uint8_t lrngPoolHead;
+/** Number of valid entries in `lrngPool`. Set to zero after changing `lrngSeed`. */
+extern uint8_t lrngPoolCount;
+
+
+/**
+ * Returns the next random number of `lrng()`. Takes it from `lrngPool` if
+ * available, else generates it directly. Both ways return the same sequence.
+ */
+#define lrngPop() \
+	((lrngPoolCount != 0) ? (--lrngPoolCount, lrngPool[(uint8_t)(lrngPoolHead++) & (LRNG_POOL_SIZE - 1)]) : lrng())
+
+
+/** Pad 1 and pad 2 buttons of the last `padsLatch()` call (same format as `padsCurrent()`). */
+extern uint16_t padLatch[2];
+/** Number of transfers in the VRAM transfer queue. */
+extern uint8_t vramQueueCount;
+
+
+/* object attribute memory shadow (see `spriteFlush()`) */
+extern uint8_t spriteTable[SPRITE_COUNT * 4]; /**< OAM low table (x, y, tile and attributes of each sprite) */
+extern uint8_t spriteHigh[SPRITE_COUNT / 4]; /**< OAM high table (x bit 8 and size bit of 4 sprites per byte) */
+extern uint8_t spriteFirst;          /**< first changed `spriteTable` sprite */
+extern uint8_t spriteEnd;            /**< sprite after the last changed `spriteTable` sprite (unchanged if not above `spriteFirst`) */
+extern uint8_t spriteHighFirst;      /**< first changed `spriteHigh` byte */
+extern uint8_t spriteHighEnd;        /**< byte after the last changed `spriteHigh` byte (unchanged if not above `spriteHighFirst`) */
+
+
+/* hot variables of `main.c` placed in the direct page (see `.reg_utility00` in utility.asm) */
+extern uint8_t i, j, j2;             /**< 8-bit loop variables */
+extern uint16_t k, m;                /**< 16-bit loop variables */
+extern int8_t dx, dy, ds;            /**< player movement (delta x, delta y, delta step; allowed values for dx/dy: -1, 0, 1) */
+extern uint8_t x, y;                 /**< player reference cell coordinates for collision detection */
+extern uint8_t x1, y1;               /**< helper variables for player collision detection */
+extern uint8_t x2, y2;               /**< helper variables for player collision detection */
+extern uint8_t * tiles;              /**< pointer to the current `renderTiles` entry */
+
+
+/* game field cell arrays (see `main.c`) */
+extern uint8_t cellMap[CELL_COUNT];  /**< type and flags of each game field element */
+extern uint8_t cellGfx[CELL_COUNT];  /**< graphic variant of each game field element */
+extern uint8_t aniCell[CELL_COUNT];  /**< remaining animation frames of each game field element */
+extern uint8_t ttlCell[CELL_COUNT];  /**< animation frame time to live of each game field element */
+extern uint8_t bombMap[CELL_COUNT];  /**< bomb pool index of each game field element */
+extern uint8_t aniList[CELL_LIST_SIZE]; /**< cell indices of all animated game field elements */
+extern uint8_t aniListCount;         /**< number of valid items in `aniList` */
+extern uint8_t dirtyCells[CELL_LIST_SIZE]; /**< cell indices of the changed game field elements */
+extern uint8_t dirtyCellCount;       /**< number of valid items in `dirtyCells` */
+extern uint8_t rayLeft[CELL_COUNT];  /**< steps to the nearest explosion stopping cell to the left */
+extern uint8_t rayRight[CELL_COUNT]; /**< steps to the nearest explosion stopping cell to the right */
+extern uint8_t rayUp[CELL_COUNT];    /**< steps to the nearest explosion stopping cell above */
+extern uint8_t rayDown[CELL_COUNT];  /**< steps to the nearest explosion stopping cell below */
+extern uint8_t explosionBombs[4];    /**< bomb pool indices hit by the last `explodeCells()` call */
+extern uint8_t explosionBombCount;   /**< number of valid items in `explosionBombs` */
 
 
 /**
@@ -45,15 +142,214 @@ void dmaCopyVramLowBytes(const uint8_t * source, const uint16_t address, const u
 void dmaCopyVramHighBytes(const uint8_t * source, const uint16_t address, const uint16_t size);
 
 
+/**
+ * Copy source bytes to WRAM via DMA channel 1.
+ *
+ * @param[in] source - source data address (not in WRAM)
+ * @param[out] address - WRAM destination address
+ * @param[in] size - number of bytes
+ * @remarks DMA cannot read from WRAM while writing to it.
+ * @remarks Channel 0 is left to the VRAM transfers of the VBlank handler.
+ */
+void dmaCopyWram(const uint8_t * source, uint8_t * address, const uint16_t size);
+
+
+/**
+ * Fill WRAM with the given source byte via DMA channel 1.
+ *
+ * @param[in] source - address of the value to fill with (not in WRAM)
+ * @param[out] address - WRAM destination address
+ * @param[in] size - number of bytes
+ * @remarks DMA cannot read from WRAM while writing to it.
+ * @remarks Channel 0 is left to the VRAM transfers of the VBlank handler.
+ */
+void dmaFillWram(const uint8_t * source, uint8_t * address, const uint16_t size);
+
+
+/**
+ * Copy WRAM bytes to WRAM with a block move (about 7 cycles per byte).
+ *
+ * @param[in] source - WRAM source address in bank $7E
+ * @param[out] address - WRAM destination address in bank $7E
+ * @param[in] size - number of bytes
+ * @remarks Source and destination shall not overlap.
+ */
+void copyWram(const uint8_t * source, uint8_t * address, const uint16_t size);
+
+
+/**
+ * Decompresses the given `scripts/lz-compress.py` output to VRAM. The data is
+ * being decompressed into the staging buffer `lzStage` in WRAM and transferred
+ * in chunks via DMA channel 1 whenever the buffer is about to run full.
+ *
+ * @param[in] source - compressed source data
+ * @param[in] address - VRAM address (word counting)
+ * @remarks Shall be called during forced blank only.
+ * @remarks The uncompressed size needs to be even.
+ * @remarks Uses `tcc__r0` to `tcc__r3` internally.
+ */
+void lzCopyVram(const uint8_t * source, const uint16_t address);
+
+
+/**
+ * Decompresses the given `scripts/lz-compress.py` output to WRAM.
+ *
+ * @param[in] source - compressed source data
+ * @param[out] address - WRAM destination address in bank $7F
+ * @remarks Uses `tcc__r0` to `tcc__r2` internally.
+ */
+void lzCopyWram(const uint8_t * source, uint8_t * address);
+
+
+/**
+ * Copy the given 16x16 cells (2x2 tiles) as tile map words to VRAM.
+ * Each cell is transferred as two rows of two tiles.
+ *
+ * @param[in] source - source tile map words; 8 bytes per cell (upper row, then lower row)
+ * @param[in] address - VRAM address of a 32 tiles wide map (word counting)
+ * @param[in] cells - list of upper left tile offsets within the map (one per cell in `source`)
+ * @param[in] count - number of entries in `cells`
+ * @remarks The source address is set once and advanced by the DMA itself.
+ */
+void dmaCopyVramCells(const uint8_t * source, const uint16_t address, const uint16_t * cells, const uint16_t count);
+
+
+/**
+ * Adds a transfer to the VRAM transfer queue. The source data is read once the
+ * queue gets flushed and needs to remain valid until then.
+ *
+ * @param[in] source - source data address
+ * @param[in] address - VRAM address (word counting)
+ * @param[in] size - source size in number of bytes
+ * @param[in] mode - `VRAM_LOW`, `VRAM_HIGH` or `VRAM_WORD`
+ * @remarks Empty transfers and transfers exceeding `VRAM_QUEUE_SIZE` are ignored.
+ * Debug builds break into the debugger via `debugBreak()` if the queue is full.
+ */
+void vramQueueAdd(const uint8_t * source, const uint16_t address, const uint16_t size, const uint16_t mode);
+
+
+/**
+ * Performs and removes all transfers in the VRAM transfer queue in the order they
+ * were added.
+ *
+ * @remarks Shall be called from the VBlank handler only.
+ */
+void vramQueueFlush(void);
+
+
+/**
+ * Transfers the changed ranges of `spriteTable` and `spriteHigh` to the object
+ * attribute memory via DMA channel 0 and marks them as unchanged.
+ *
+ * @remarks Shall be called from the VBlank handler only.
+ * @remarks Uses `tcc__r0` internally.
+ */
+void spriteFlush(void);
+
+
+/**
+ * Updates the explosion ray lengths (`rayLeft` etc.) after the `CELL_STOP`
+ * flag of the given cell has changed. Only the cells up to the next stopping
+ * cell in each direction are visited.
+ *
+ * @param[in] cell - cell index with the changed `CELL_STOP` flag
+ * @remarks Requires `CELL_STOP` of the solid walls around the game field.
+ */
+void updateRays(const uint16_t cell);
+
+
+#ifndef USE_C_EXPLOSION
+/**
+ * Performs the explosion of a bomb on the game field cell arrays. Sets the
+ * center and each of the four rays up to the given range to flames and starts
+ * their animation. Each ray is limited by its precomputed length (see
+ * `rayLeft`). Handles overlapping explosions, breaking walls and destroys
+ * power-ups. Bombs hit by the explosion are being returned in `explosionBombs`
+ * for the chain reaction.
+ *
+ * @param[in] cell - cell index of the bomb
+ * @param[in] range - explosion range
+ * @remarks Equivalent to the C implementation built with `USE_C_EXPLOSION=1`.
+ * @remarks Uses `tcc__r0` to `tcc__r3` internally.
+ */
+void explodeCells(const uint16_t cell, const uint16_t range);
+#endif /* not USE_C_EXPLOSION */
+
+
+/**
+ * Writes the four tile map words of the game field cell `j` to `tiles`. Empty
+ * cells use `FIELD_EMPTY`. All other cells use the 2x2 tiles starting at the
+ * tile index `j2`, mirrored according to the `cellGfx` flip flags.
+ *
+ * @remarks Reads `j`, `j2` and `tiles` via direct page addressing.
+ */
+void renderCellTiles(void);
+
+
+/**
+ * Splits the vertical scroll offset of the foreground layer via HDMA channel 7.
+ * The first screen lines use `upper` and all remaining lines use `lower`.
+ *
+ * @param[in] lines - number of screen lines with the upper offset (1 to 127)
+ * @param[in] upper - vertical scroll offset of the upper screen lines
+ * @param[in] lower - vertical scroll offset of the remaining screen lines
+ * @remarks Shall be called from the VBlank handler only.
+ */
+void setSplitScroll(const uint16_t lines, const uint16_t upper, const uint16_t lower);
+
+
+/**
+ * Returns the current scanline by latching the PPU vertical counter.
+ *
+ * @return scanline (0 to 261 for NTSC, 0 to 311 for PAL)
+ * @remarks Requires bit 7 of the I/O port register $4201 to be set (default).
+ */
+uint16_t getScanline(void);
+
+
+/**
+ * Reads the current pad 1 and pad 2 buttons via the serial controller port
+ * interface into `padLatch`. This allows to sample the pads later than the
+ * auto-joypad read at the beginning of the VBlank period.
+ *
+ * @remarks Waits for the end of a running auto-joypad read.
+ * @remarks Takes about 4000 clock cycles (~3 scanlines) due to the slow controller port access.
+ */
+void padsLatch(void);
+
+
+#ifdef USE_FASTROM
+/**
+ * Enables the 3.58 MHz ROM access for the banks $80 and above. The code and
+ * constants of this project are being addressed via these banks in builds
+ * with `USE_FASTROM` (see `hdr.asm`).
+ *
+ * @remarks Shall be called once at start-up before any time critical code.
+ */
+void fastRomInit(void);
+#endif /* USE_FASTROM */
+
+
 /**
  * Linear random number generator. A full period is (2^32)-1.
  *
  * @return random number in the range 0..65535 (16-bit)
  * @see https://www.jstatsoft.org/article/view/v008i14
  * @remarks Operates on the variable `rndSeed` to generate the next value. `lrngSeed` shall not be zero!
- * @remarks Takes 824 clock cycles (~0.6 scanlines).
+ * @remarks Takes about 840 clock cycles (~0.6 scanlines).
+ * @remarks Use `lrngPop()` instead while `lrngPool` is in use.
  */
 uint16_t lrng(void);
 
 
+/**
+ * Appends new values of `lrng()` to `lrngPool` until it is full or the given
+ * scanline is reached.
+ *
+ * @param[in] line - scanline at which no further value is being generated
+ * @remarks Checks the scanline before each value (~0.6 scanlines).
+ */
+void lrngFill(const uint16_t line);
+
+
 #endif /* _UTILITY_H_ */